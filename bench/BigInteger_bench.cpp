@@ -0,0 +1,192 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include "../src/BigInteger.h"
+
+using namespace BigNum;
+
+namespace {
+    // random decimal number of exactly the given number of digits
+    std::string randomDigits(size_t digits, uint64_t seed) {
+        std::mt19937_64 gen(seed);
+        std::string res(digits, '0');
+        for (auto &c : res)
+            c = static_cast<char>('0' + gen() % 10);
+        res[0] = static_cast<char>('1' + gen() % 9);
+        return res;
+    }
+
+    BigInteger randomValue(size_t digits, uint64_t seed) {
+        return BigInteger(randomDigits(digits, seed));
+    }
+
+    // operand sizes in decimal digits, from one limb to a million digits
+    void digitSizes(benchmark::internal::Benchmark *bench) {
+        for (int64_t digits : {19, 100, 1000, 10000, 100000, 1000000})
+            bench->Arg(digits);
+    }
+
+    // operand sizes in limbs in powers of two, for locating the multiplication crossovers
+    void limbSizes(benchmark::internal::Benchmark *bench) {
+        bench->RangeMultiplier(2)->Range(1, 1 << 16);
+    }
+
+    // throughput in operand bytes and the operand size for the JSON output
+    void setThroughput(benchmark::State &state, const BigInteger &operand, size_t operands = 1) {
+        size_t bytes = (operand.bitLength() + 7) / 8 * operands;
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+        state.counters["bits"] = static_cast<double>(operand.bitLength());
+    }
+}
+
+static void BM_Parse(benchmark::State &state) {
+    std::string str = randomDigits(state.range(0), 1);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(BigInteger(str));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * str.size()));
+}
+BENCHMARK(BM_Parse)->Apply(digitSizes);
+
+static void BM_ToString(benchmark::State &state) {
+    BigInteger a = randomValue(state.range(0), 2);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a.toString());
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * state.range(0)));
+}
+BENCHMARK(BM_ToString)->Apply(digitSizes);
+
+static void BM_Compare(benchmark::State &state) {
+    // equal but for the last digit, so the whole magnitude is scanned
+    std::string str = randomDigits(state.range(0), 3);
+    BigInteger a(str);
+    str.back() = str.back() == '9' ? '8' : static_cast<char>(str.back() + 1);
+    BigInteger b(str);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a < b);
+    setThroughput(state, a, 2);
+}
+BENCHMARK(BM_Compare)->Apply(digitSizes);
+
+static void BM_Add(benchmark::State &state) {
+    BigInteger a = randomValue(state.range(0), 4), b = randomValue(state.range(0), 5);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a + b);
+    setThroughput(state, a, 2);
+}
+BENCHMARK(BM_Add)->Apply(digitSizes);
+
+static void BM_Sub(benchmark::State &state) {
+    BigInteger a = randomValue(state.range(0), 6), b = randomValue(state.range(0), 7);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a - b);
+    setThroughput(state, a, 2);
+}
+BENCHMARK(BM_Sub)->Apply(digitSizes);
+
+static void BM_Mul(benchmark::State &state) {
+    BigInteger a = randomValue(state.range(0), 8), b = randomValue(state.range(0), 9);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a * b);
+    setThroughput(state, a, 2);
+}
+BENCHMARK(BM_Mul)->Apply(digitSizes);
+
+static void BM_MulLimbs(benchmark::State &state) {
+    // 64 * log10(2) digits per limb
+    size_t digits = static_cast<size_t>(state.range(0) * 19.27) + 1;
+    BigInteger a = randomValue(digits, 10), b = randomValue(digits, 11);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a * b);
+    setThroughput(state, a, 2);
+}
+BENCHMARK(BM_MulLimbs)->Apply(limbSizes);
+
+static void BM_Div(benchmark::State &state) {
+    // quotient and divisor of the same size
+    BigInteger a = randomValue(2 * state.range(0), 12), b = randomValue(state.range(0), 13);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a / b);
+    setThroughput(state, a);
+}
+BENCHMARK(BM_Div)->Apply(digitSizes);
+
+static void BM_Mod(benchmark::State &state) {
+    BigInteger a = randomValue(2 * state.range(0), 14), b = randomValue(state.range(0), 15);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a % b);
+    setThroughput(state, a);
+}
+BENCHMARK(BM_Mod)->Apply(digitSizes);
+
+static void BM_ValueInt64(benchmark::State &state) {
+    BigInteger a(-1234567890123456789);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a.value<int64_t>());
+}
+BENCHMARK(BM_ValueInt64);
+
+static void BM_ValueUint32(benchmark::State &state) {
+    BigInteger a(4000000000);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a.value<uint32_t>());
+}
+BENCHMARK(BM_ValueUint32);
+
+static void BM_CompareInt64(benchmark::State &state) {
+    BigInteger a = randomValue(state.range(0), 16);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a < 1234567890123456789);
+    setThroughput(state, a);
+}
+BENCHMARK(BM_CompareInt64)->Apply(digitSizes);
+
+static void BM_AddInt64(benchmark::State &state) {
+    BigInteger a = randomValue(state.range(0), 17);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a + 1234567890123456789);
+    setThroughput(state, a);
+}
+BENCHMARK(BM_AddInt64)->Apply(digitSizes);
+
+static void BM_SubInt64(benchmark::State &state) {
+    BigInteger a = randomValue(state.range(0), 18);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a - 1234567890123456789);
+    setThroughput(state, a);
+}
+BENCHMARK(BM_SubInt64)->Apply(digitSizes);
+
+static void BM_MulInt64(benchmark::State &state) {
+    BigInteger a = randomValue(state.range(0), 19);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a * 1234567890123456789);
+    setThroughput(state, a);
+}
+BENCHMARK(BM_MulInt64)->Apply(digitSizes);
+
+static void BM_DivInt64(benchmark::State &state) {
+    BigInteger a = randomValue(state.range(0), 20);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a / 1234567890123456789);
+    setThroughput(state, a);
+}
+BENCHMARK(BM_DivInt64)->Apply(digitSizes);
+
+static void BM_ModInt64(benchmark::State &state) {
+    BigInteger a = randomValue(state.range(0), 21);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a % 1234567890123456789);
+    setThroughput(state, a);
+}
+BENCHMARK(BM_ModInt64)->Apply(digitSizes);
+
+static void BM_AddAssignInt64(benchmark::State &state) {
+    BigInteger a = randomValue(state.range(0), 22);
+    for (auto _ : state) {
+        a += 1234567890123456789;
+        benchmark::ClobberMemory();
+    }
+    setThroughput(state, a);
+}
+BENCHMARK(BM_AddAssignInt64)->Apply(digitSizes);
@@ -1,89 +1,474 @@
-#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+#include <typeinfo>
 #include "BigInteger.h"
+#include "BigIntegerParser.h"
+#include "Instrumentation.h"
+#include "conversion.h"
+#include "divide.h"
+#include "gcd.h"
 #include "helpers.h"
+#include "kernels.h"
+#include "modular.h"
+#include "multiply.h"
+#include "primes.h"
+#include "roots.h"
 
 namespace BigNum {
+    namespace {
+        int compareMagnitudes(const LimbStorage &a, const LimbStorage &b) {
+            return kernels::compare(a.data(), a.size(), b.data(), b.size());
+        }
+
+        // writes n > |magnitude| limbs of the two's complement representation of sign * magnitude
+        void toTwosComplement(const LimbStorage &magnitude, int sign, uint64_t *r, size_t n) {
+            std::copy(magnitude.begin(), magnitude.end(), r);
+            std::fill(r + magnitude.size(), r + n, 0);
+            if (sign < 0) {
+                // -m = ~(m - 1)
+                kernels::sub1(r, r, n, 1);
+                kernels::comN(r, r, n);
+            }
+        }
+
+        // collects word-sized factors, multiplying as many as fit into one limb before any big product
+        class WordProduct {
+        public:
+            void multiply(uint64_t factor) {
+                uint64_t next;
+                if (__builtin_mul_overflow(current, factor, &next)) {
+                    words.push_back(BigInteger::from(current));
+                    next = factor;
+                }
+                current = next;
+            }
+
+            BigInteger result() {
+                words.push_back(BigInteger::from(current));
+                return BigInteger::product(words);
+            }
+
+        private:
+            std::vector<BigInteger> words;
+            uint64_t current = 1;
+        };
+
+        // exponent of the prime p in n!, by Legendre's formula
+        uint64_t factorialExponent(uint64_t n, uint64_t p) {
+            uint64_t res = 0;
+            while (n >= p) {
+                n /= p;
+                res += n;
+            }
+            return res;
+        }
+
+        // product of p^exponent(p) over the given primes: the primes whose exponent has bit i set are
+        // multiplied together, and the running result is squared once per bit below the top one
+        template<typename Exponent>
+        BigInteger primePowerProduct(const std::vector<uint64_t> &primes, Exponent exponent) {
+            std::vector<uint64_t> exponents(primes.size());
+            uint64_t bits = 0;
+            for (size_t i = 0; i < primes.size(); i++) {
+                exponents[i] = exponent(primes[i]);
+                bits |= exponents[i];
+            }
+
+            BigInteger res(1);
+            for (int bit = bits ? 63 - __builtin_clzll(bits) : -1; bit >= 0; bit--) {
+                res *= res;
+                WordProduct factors;
+                for (size_t i = 0; i < primes.size(); i++) {
+                    if (exponents[i] >> bit & 1)
+                        factors.multiply(primes[i]);
+                }
+                res *= factors.result();
+            }
+            return res;
+        }
+
+        // longest varint header, enough for any 64-bit value
+        constexpr size_t MAX_VARINT_BYTES = 10;
+
+        size_t writeVarint(uint64_t value, unsigned char *out) {
+            size_t n = 0;
+            for (; value >= 0x80; value >>= 7)
+                out[n++] = static_cast<unsigned char>(value | 0x80);
+            out[n++] = static_cast<unsigned char>(value);
+            return n;
+        }
+
+        // decodes a varint from at most size bytes, returning its length or 0 when it is truncated,
+        // overflows 64 bits or has a redundant zero byte at the end
+        size_t readVarint(const unsigned char *in, size_t size, uint64_t &value) {
+            value = 0;
+            for (size_t i = 0; i < std::min(size, MAX_VARINT_BYTES); i++) {
+                uint64_t byte = in[i] & 0x7f;
+                if (i == MAX_VARINT_BYTES - 1 && byte > 1)
+                    return 0;
+                value |= byte << (7 * i);
+                if (!(in[i] & 0x80))
+                    return i > 0 && byte == 0 ? 0 : i + 1;
+            }
+            return 0;
+        }
+
+        void storeLimbs(const uint64_t *limbs, size_t n, unsigned char *out) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            std::memcpy(out, limbs, n * sizeof(uint64_t));
+#else
+            for (size_t i = 0; i < n; i++) {
+                for (size_t j = 0; j < sizeof(uint64_t); j++)
+                    out[i * sizeof(uint64_t) + j] = static_cast<unsigned char>(limbs[i] >> (8 * j));
+            }
+#endif
+        }
+
+        void loadLimbs(const unsigned char *in, size_t n, uint64_t *limbs) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            std::memcpy(limbs, in, n * sizeof(uint64_t));
+#else
+            for (size_t i = 0; i < n; i++) {
+                limbs[i] = 0;
+                for (size_t j = 0; j < sizeof(uint64_t); j++)
+                    limbs[i] |= static_cast<uint64_t>(in[i * sizeof(uint64_t) + j]) << (8 * j);
+            }
+#endif
+        }
+
+        // limb count and sign from a varint header, rejecting negative zero and counts no buffer can hold
+        size_t decodeHeader(uint64_t header, int &sign) {
+            if (header == 1 || header >> 1 > std::numeric_limits<size_t>::max() / sizeof(uint64_t))
+                throw std::invalid_argument("Malformed serialized BigInteger");
+            sign = header & 1 ? -1 : 1;
+            return static_cast<size_t>(header >> 1);
+        }
+
+        uint64_t magnitudeOf(int64_t val) {
+            // negate in unsigned arithmetic so that INT64_MIN does not overflow
+            return val < 0 ? 0 - static_cast<uint64_t>(val) : static_cast<uint64_t>(val);
+        }
+
+        int signOf(int64_t val) {
+            return val < 0 ? -1 : 1;
+        }
+
+        // the 64 bits of the magnitude starting at bit pos, zero above its top
+        uint64_t bitsAt(const LimbStorage &limbs, size_t pos) {
+            size_t word = pos / kernels::LIMB_BITS;
+            unsigned offset = pos % kernels::LIMB_BITS;
+            uint64_t low = word < limbs.size() ? limbs[word] >> offset : 0;
+            uint64_t high = offset && word + 1 < limbs.size() ? limbs[word + 1] << (kernels::LIMB_BITS - offset) : 0;
+            return low | high;
+        }
+
+        // whether any bit of the magnitude below bit pos is set; the scan only goes past the first limb
+        // for results exactly halfway between two floating-point values
+        bool anyBitBelow(const LimbStorage &limbs, size_t pos) {
+            size_t word = pos / kernels::LIMB_BITS;
+            unsigned offset = pos % kernels::LIMB_BITS;
+            if (offset && (limbs[word] & ((uint64_t(1) << offset) - 1)))
+                return true;
+            for (size_t i = word; i-- > 0;) {
+                if (limbs[i])
+                    return true;
+            }
+            return false;
+        }
+
+        int clampExponent(int64_t exponent) {
+            return static_cast<int>(std::max<int64_t>(INT_MIN / 2, std::min<int64_t>(INT_MAX / 2, exponent)));
+        }
+
+        // n / k from which binomial multiplies the k factors of n! / (n - k)! and divides by k! instead of
+        // sieving up to n
+        constexpr uint64_t BINOMIAL_FALLING_RATIO = 64;
+    }
+
     template<typename T>
-    T BigInteger::value() {
-        if (std::is_unsigned<T>::value && sign < 0)
-            throw SignException("Casting negative value to unsigned");
+    bool BigInteger::fitsIn() const noexcept {
+        using Wide = unsigned __int128;
+        static_assert(sizeof(T) <= sizeof(Wide), "fitsIn is for built-in integer types");
+        size_t n = limbs.size();
+        Wide magnitude = (Wide) (n > 1 ? limbs[1] : 0) << 64 | (n > 0 ? limbs[0] : 0);
+        // a negative value may reach max + 1
+        Wide maxMagnitude = static_cast<Wide>(std::numeric_limits<T>::max()) + (sign < 0);
+        return (n <= 2) & (magnitude <= maxMagnitude) & (std::is_signed<T>::value | (sign > 0));
+    }
 
-        if (*this > BigInteger::from<T>(std::numeric_limits<T>::max()) ||
-            *this < BigInteger::from<T>(std::numeric_limits<T>::min())) {
+    template<typename T>
+    T BigInteger::value() const {
+        if (!fitsIn<T>()) {
+            if (std::is_unsigned<T>::value && sign < 0)
+                throw SignException("Casting negative value to unsigned");
             auto msg = "BigInteger '" + toString() + "' cannot be represented as type: " + typeid(T).name();
             throw OverflowException(msg.c_str());
         }
 
+        using Wide = unsigned __int128;
+        size_t n = limbs.size();
+        Wide magnitude = (Wide) (n > 1 ? limbs[1] : 0) << 64 | (n > 0 ? limbs[0] : 0);
+        return static_cast<T>(sign < 0 ? 0 - magnitude : magnitude);
+    }
+
+    double BigInteger::toDouble() const {
+        return toFloating<double>();
+    }
+
+    long double BigInteger::toLongDouble() const {
+        return toFloating<long double>();
+    }
+
+    template<typename F>
+    F BigInteger::toFloating() const {
+        constexpr int DIGITS = std::numeric_limits<F>::digits;
+        static_assert(DIGITS <= 64, "the significand is gathered in one limb");
+        size_t bits = bitLength();
+        if (bits <= DIGITS) {
+            // exact
+            F res = static_cast<F>(limbs.empty() ? 0 : limbs[0]);
+            return sign < 0 ? -res : res;
+        }
 
-        T res = 0;
-        size_t pow = 1;
-        for (auto digit : digits) {
-            res += digit * pow;
-            pow *= 10;
+        // round the top DIGITS bits to nearest, ties to even
+        size_t shift = bits - DIGITS;
+        uint64_t significand = bitsAt(limbs, shift);
+        bool roundBit = bitsAt(limbs, shift - 1) & 1;
+        if (roundBit && ((significand & 1) || anyBitBelow(limbs, shift - 1))) {
+            significand++;
+            if (significand == 0 || (DIGITS < 64 && significand >> (DIGITS % 64))) {
+                // carried into a new top bit
+                significand = uint64_t(1) << (DIGITS - 1);
+                shift++;
+            }
         }
-        res *= sign;
+        F res = std::ldexp(static_cast<F>(significand), clampExponent(static_cast<int64_t>(shift)));
+        return sign < 0 ? -res : res;
+    }
+
+    BigInteger BigInteger::fromFloating(long double val) {
+        if (!std::isfinite(val))
+            throw std::invalid_argument("Cannot convert a non-finite value");
+        int exponent;
+        long double fraction = std::frexp(std::fabs(val), &exponent);
+        // fraction is in [0.5, 1), so its 64 leading bits hold the whole significand
+        BigInteger res = fromMagnitude(static_cast<uint64_t>(std::ldexp(fraction, 64)), 1);
+        if (exponent >= 64)
+            res <<= static_cast<size_t>(exponent - 64);
+        else
+            res >>= static_cast<size_t>(64 - exponent);
+        res.sign = val < 0 ? -1 : 1;
+        res.trimZeros();
         return res;
     }
 
     std::string BigInteger::toString() const {
-        std::stringstream res;
-        if (sign < 0)
-            res << '-';
-        if (digits.empty())
-            return "0";
+        BIGNUM_RECORD_OPERATION(ToString, limbs.size());
+        std::string res(decimalLength(), '\0');
+        char *end = to_chars(&res[0], &res[0] + res.size(), *this).ptr;
+        res.resize(static_cast<size_t>(end - res.data()));
+        return res;
+    }
+
+    size_t BigInteger::decimalLength() const noexcept {
+        return kernels::decimalDigitsBound(limbs.data(), limbs.size()) + (sign < 0 ? 1 : 0);
+    }
+
+    std::to_chars_result to_chars(char *first, char *last, const BigInteger &value) {
+        BIGNUM_RECORD_OPERATION(ToString, value.limbs.size());
+        auto size = static_cast<size_t>(last - first);
+        if (value.limbs.empty()) {
+            if (size == 0)
+                return {last, std::errc::value_too_large};
+            *first = '0';
+            return {first + 1, std::errc()};
+        }
 
-        for (auto it = digits.rbegin(); it != digits.rend(); it++) {
-            res << std::to_string(*it);
+        if (value.sign < 0) {
+            if (size == 0)
+                return {last, std::errc::value_too_large};
+            *first++ = '-';
         }
-        return res.str();
+        // the kernel checks the exact length once it knows the leading chunk, so a buffer one short of
+        // decimalLength() still takes a number whose bound was one too high
+        char *end = kernels::toDecimal(value.limbs.data(), value.limbs.size(), first, last);
+        if (!end)
+            return {last, std::errc::value_too_large};
+        return {end, std::errc()};
     }
 
-    BigInteger::BigInteger(int64_t val) : BigInteger(std::to_string(val)) {}
+    BigInteger::BigInteger(const BigInteger &oth, std::pmr::memory_resource *resource)
+            : sign(oth.sign), limbs(oth.limbs, resource) {}
 
-    BigInteger::BigInteger(std::string str) {
-        trim(str);
+    BigInteger::BigInteger(int64_t val) {
+        sign = signOf(val);
+        uint64_t magnitude = magnitudeOf(val);
+        if (magnitude)
+            limbs.push_back(magnitude);
+    }
+
+    BigInteger::BigInteger(std::string_view str) {
+        str = trim(str);
         if (str.empty())
             throw std::invalid_argument("Cannot parse empty string");
+        const char *last = str.data() + str.size();
+        auto [ptr, ec] = from_chars(str.data(), last, *this);
+        if (ec != std::errc() || ptr != last)
+            throw std::invalid_argument("Cannot parse string as number");
+    }
 
-        if (str[0] == '-') {
-            sign = -1;
-            str = std::string(str.begin() + 1, str.end());
+    std::from_chars_result from_chars(const char *first, const char *last, BigInteger &value) {
+        // a limb holds about 19 decimal digits
+        BIGNUM_RECORD_OPERATION(Parse, static_cast<size_t>(last - first) / 19);
+        const char *digits = first != last && *first == '-' ? first + 1 : first;
+        const char *end = std::find_if(digits, last, [](char c) { return c < '0' || c > '9'; });
+        if (end == digits)
+            return {first, std::errc::invalid_argument};
+
+        // short numbers are converted on the stack, so a result that fits in the inline limbs does not allocate
+        auto len = static_cast<size_t>(end - digits);
+        if (len < kernels::FROM_DECIMAL_THRESHOLD) {
+            kernels::limb_t buffer[kernels::decimalLimbsBound(kernels::FROM_DECIMAL_THRESHOLD)];
+            value.limbs.assign(buffer, buffer + kernels::fromDecimal(digits, len, buffer));
+        } else {
+            value.limbs.clear();
+            value.limbs.resize(kernels::decimalLimbsBound(len));
+            value.limbs.resize(kernels::fromDecimal(digits, len, value.limbs.data()));
         }
-        for (auto it = str.rbegin(); it != str.rend(); it++) {
-            if (!std::isdigit(*it))
-                throw std::invalid_argument("Cannot parse string as number");
+        value.sign = digits != first && !value.limbs.empty() ? -1 : 1;
+        return {end, std::errc()};
+    }
 
-            digits.push_back(*it - '0'); // ascii value to actual number
+    std::istream &operator>>(std::istream &in, BigInteger &value) {
+        std::istream::sentry sentry(in);
+        if (!sentry)
+            return in;
+
+        BigIntegerParser parser;
+        auto *buffer = in.rdbuf();
+        for (int c; !parser.done();) {
+            c = buffer->sgetc();
+            if (c == std::char_traits<char>::eof()) {
+                in.setstate(std::ios::eofbit);
+                break;
+            }
+            char ch = static_cast<char>(c);
+            if (parser.feed(&ch, &ch + 1) == &ch + 1)
+                buffer->sbumpc();
         }
+        if (parser.finish(value) != std::errc())
+            in.setstate(std::ios::failbit);
+        return in;
+    }
 
+    size_t BigInteger::serializedSize() const {
+        unsigned char header[MAX_VARINT_BYTES];
+        return writeVarint(limbs.size() * 2 + (sign < 0), header) + limbs.size() * sizeof(uint64_t);
     }
 
-    bool BigInteger::operator>(const BigInteger &oth) const {
-        if (sign > 0 && oth.sign < 0)return true;
-        if (sign < 0 && oth.sign > 0)return false;
+    size_t BigInteger::serialize(void *buffer) const {
+        auto *out = static_cast<unsigned char *>(buffer);
+        size_t n = writeVarint(limbs.size() * 2 + (sign < 0), out);
+        storeLimbs(limbs.data(), limbs.size(), out + n);
+        return n + limbs.size() * sizeof(uint64_t);
+    }
+
+    void BigInteger::serialize(std::ostream &out) const {
+        unsigned char header[MAX_VARINT_BYTES];
+        out.write(reinterpret_cast<const char *>(header), static_cast<std::streamsize>(
+                writeVarint(limbs.size() * 2 + (sign < 0), header)));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        out.write(reinterpret_cast<const char *>(limbs.data()),
+                  static_cast<std::streamsize>(limbs.size() * sizeof(uint64_t)));
+#else
+        unsigned char word[sizeof(uint64_t)];
+        for (uint64_t limb : limbs) {
+            storeLimbs(&limb, 1, word);
+            out.write(reinterpret_cast<const char *>(word), sizeof(word));
+        }
+#endif
+    }
 
+    BigInteger BigInteger::deserialize(const void *buffer, size_t size, size_t *consumed) {
+        const auto *in = static_cast<const unsigned char *>(buffer);
+        uint64_t header;
+        size_t headerSize = readVarint(in, size, header);
+        if (headerSize == 0)
+            throw std::invalid_argument("Malformed serialized BigInteger");
 
-        if (oth.digits.size() != digits.size())
-            return (digits.size() > oth.digits.size()) != (sign < 0);
-        for (int64_t i = digits.size() - 1; i >= 0; i--) {
-            if (digits.at(i) != oth.digits.at(i)) {
-                return (digits.at(i) > oth.digits.at(i)) != (sign < 0);
-            }
+        BigInteger res;
+        size_t n = decodeHeader(header, res.sign);
+        if (n > (size - headerSize) / sizeof(uint64_t))
+            throw std::invalid_argument("Truncated serialized BigInteger");
+        res.limbs.resize(n);
+        loadLimbs(in + headerSize, n, res.limbs.data());
+        if (n > 0 && res.limbs.back() == 0)
+            throw std::invalid_argument("Malformed serialized BigInteger");
+        if (consumed)
+            *consumed = headerSize + n * sizeof(uint64_t);
+        return res;
+    }
+
+    BigInteger BigInteger::deserialize(std::istream &in) {
+        unsigned char header[MAX_VARINT_BYTES];
+        size_t headerSize = 0;
+        do {
+            int c = in.get();
+            if (c == std::char_traits<char>::eof())
+                throw std::invalid_argument("Truncated serialized BigInteger");
+            header[headerSize++] = static_cast<unsigned char>(c);
+        } while (header[headerSize - 1] & 0x80 && headerSize < MAX_VARINT_BYTES);
+        uint64_t value;
+        if (readVarint(header, headerSize, value) != headerSize)
+            throw std::invalid_argument("Malformed serialized BigInteger");
+
+        BigInteger res;
+        size_t n = decodeHeader(value, res.sign);
+        // grows with the data actually read, so a corrupt length cannot force a huge allocation
+        constexpr size_t CHUNK_LIMBS = 4096;
+        unsigned char bytes[CHUNK_LIMBS * sizeof(uint64_t)];
+        for (size_t done = 0; done < n;) {
+            size_t chunk = std::min(CHUNK_LIMBS, n - done);
+            in.read(reinterpret_cast<char *>(bytes), static_cast<std::streamsize>(chunk * sizeof(uint64_t)));
+            if (static_cast<size_t>(in.gcount()) != chunk * sizeof(uint64_t))
+                throw std::invalid_argument("Truncated serialized BigInteger");
+            res.limbs.resize(done + chunk);
+            loadLimbs(bytes, chunk, res.limbs.data() + done);
+            done += chunk;
         }
+        if (n > 0 && res.limbs.back() == 0)
+            throw std::invalid_argument("Malformed serialized BigInteger");
+        return res;
+    }
+
+    int BigInteger::compareTo(const BigInteger &oth) const {
+        BIGNUM_RECORD_OPERATION(Compare, std::max(limbs.size(), oth.limbs.size()));
+        if (sign != oth.sign)
+            return sign;
+        return sign * compareMagnitudes(limbs, oth.limbs);
+    }
 
-        return false; // equal
+    bool BigInteger::operator>(const BigInteger &oth) const {
+        return compareTo(oth) > 0;
     }
 
     bool BigInteger::operator<(const BigInteger &oth) const {
-        return !(*this >= oth);
+        return compareTo(oth) < 0;
     }
 
     bool BigInteger::operator>=(const BigInteger &oth) const {
-        return *this > oth || *this == oth;
+        return compareTo(oth) >= 0;
     }
 
     bool BigInteger::operator==(const BigInteger &oth) const {
-        return sign == oth.sign && digits == oth.digits;
+        BIGNUM_RECORD_OPERATION(Compare, std::max(limbs.size(), oth.limbs.size()));
+        return sign == oth.sign && limbs == oth.limbs;
     }
 
     bool BigInteger::operator!=(const BigInteger &oth) const {
@@ -91,338 +476,884 @@ namespace BigNum {
     }
 
     bool BigInteger::operator<=(const BigInteger &oth) const {
-        return *this < oth || *this == oth;
+        return compareTo(oth) <= 0;
     }
 
     template<typename T>
     BigInteger BigInteger::from(T val) {
-        return BigInteger(std::to_string(val));
+        if constexpr (std::is_floating_point<T>::value) {
+            return fromFloating(val);
+        } else if constexpr (sizeof(T) > sizeof(uint64_t)) {
+            using Wide = unsigned __int128;
+            Wide magnitude = val < 0 ? 0 - static_cast<Wide>(val) : static_cast<Wide>(val);
+            BigInteger res = fromMagnitude(static_cast<uint64_t>(magnitude), val < 0 ? -1 : 1);
+            if (magnitude >> 64) {
+                res.limbs.resize(1);
+                res.limbs.push_back(static_cast<uint64_t>(magnitude >> 64));
+                res.sign = val < 0 ? -1 : 1;
+            }
+            return res;
+        } else if (std::is_signed<T>::value) {
+            return BigInteger(static_cast<int64_t>(val));
+        } else {
+            return fromMagnitude(static_cast<uint64_t>(val), 1);
+        }
     }
 
     bool BigInteger::operator>(int64_t val) const {
-        return *this > BigInteger(val);
+        return compareTo(magnitudeOf(val), signOf(val)) > 0;
     }
 
     bool BigInteger::operator<(int64_t val) const {
-        return *this < BigInteger(val);
+        return compareTo(magnitudeOf(val), signOf(val)) < 0;
     }
 
     bool BigInteger::operator>=(int64_t val) const {
-        return *this >= BigInteger(val);
+        return compareTo(magnitudeOf(val), signOf(val)) >= 0;
     }
 
     bool BigInteger::operator<=(int64_t val) const {
-        return *this <= BigInteger(val);
+        return compareTo(magnitudeOf(val), signOf(val)) <= 0;
     }
 
     bool BigInteger::operator!=(int64_t val) const {
-        return *this != BigInteger(val);
+        return !(*this == val);
     }
 
     bool BigInteger::operator==(int64_t val) const {
-        return *this == BigInteger(val);
+        BIGNUM_RECORD_OPERATION(Compare, limbs.size());
+        uint64_t magnitude = magnitudeOf(val);
+        if (magnitude == 0)
+            return limbs.empty();
+        return limbs.size() == 1 && limbs[0] == magnitude && sign == signOf(val);
     }
 
     BigInteger BigInteger::operator+(const BigInteger &oth) const {
-        if (sign != oth.sign) {
-            if (sign < 0) {
-                return oth - this->abs();
-            }
-            return *this - oth.abs();
-        }
+        BIGNUM_RECORD_OPERATION(Add, std::max(limbs.size(), oth.limbs.size()));
+        if (sign == oth.sign)
+            return addMagnitudes(*this, oth, sign);
+        if (compareMagnitudes(limbs, oth.limbs) >= 0)
+            return subtractMagnitudes(*this, oth, sign);
+        return subtractMagnitudes(oth, *this, oth.sign);
+    }
+
+    BigInteger BigInteger::operator*(const BigInteger &oth) const {
+        BIGNUM_RECORD_OPERATION(Multiply, std::max(limbs.size(), oth.limbs.size()));
         BigInteger res;
-        int rest = 0;
-        for (size_t i = 0; i < std::max(digits.size(), oth.digits.size()); i++) {
-            res.digits.push_back(rest);
-            if (i < digits.size())
-                res.digits.back() += digits.at(i);
-            if (i < oth.digits.size())
-                res.digits.back() += oth.digits.at(i);
-            rest = res.digits.back() / 10;
-            res.digits.back() %= 10;
-        }
-
-        if (rest)
-            res.digits.push_back(rest);
-        res.sign = sign;
+        if (limbs.empty() || oth.limbs.empty())
+            return res;
+
+        const auto &longer = limbs.size() >= oth.limbs.size() ? limbs : oth.limbs;
+        const auto &shorter = limbs.size() >= oth.limbs.size() ? oth.limbs : limbs;
+        res.limbs.resize(limbs.size() + oth.limbs.size());
+        kernels::mul(res.limbs.data(), longer.data(), longer.size(), shorter.data(), shorter.size());
+        res.sign = sign * oth.sign;
         res.trimZeros();
         return res;
     }
 
-    BigInteger BigInteger::operator*(const BigInteger &oth) const {
-        BigInteger res;
+    BigInteger BigInteger::operator-(const BigInteger &oth) const {
+        BIGNUM_RECORD_OPERATION(Subtract, std::max(limbs.size(), oth.limbs.size()));
         if (sign != oth.sign)
-            return this->abs() * oth.abs();
+            return addMagnitudes(*this, oth, sign);
+        if (compareMagnitudes(limbs, oth.limbs) >= 0)
+            return subtractMagnitudes(*this, oth, sign);
+        return subtractMagnitudes(oth, *this, -sign);
+    }
 
-        for (size_t i = 0; i < oth.digits.size(); i++) {
-            BigInteger part;
-            auto mul = this->abs();
-            for (int _ = 0; _ < oth.digits.at(i); _++)
-                part += mul;
-            part.multiplyByFactorOf10(i);
-            res += part;
-        }
+    BigInteger BigInteger::operator/(const BigInteger &oth) const {
+        BIGNUM_RECORD_OPERATION(Divide, limbs.size());
+        return divmod(oth).first;
+    }
 
+    BigInteger BigInteger::operator+(int64_t val) const {
+        BIGNUM_RECORD_OPERATION(Add, limbs.size());
+        BigInteger res;
+        // room for the carry, so the copy is the only allocation
+        res.limbs.reserve(limbs.size() + 1);
+        res = *this;
+        res.addWordInPlace(magnitudeOf(val), signOf(val));
         return res;
     }
 
-    BigInteger BigInteger::operator-(const BigInteger &oth) const {
-        if (sign != oth.sign) {
-            if (sign < 0) {
-                return -(oth + this->abs());
-            }
-            return *this + oth.abs();
-        }
-        if (sign < 0 && oth.sign < 0) {
-            return oth.abs() - this->abs();
-        }
-        if (oth.abs() > *this)
-            return -(oth.abs() - *this);
+    BigInteger BigInteger::operator*(int64_t val) const {
+        BIGNUM_RECORD_OPERATION(Multiply, limbs.size());
         BigInteger res;
-        int rest = 0;
-        for (size_t i = 0; i < std::max(digits.size(), oth.digits.size()); i++) {
-            res.digits.push_back(rest);
-            rest = 0;
-            if (i < digits.size())
-                res.digits.back() += digits.at(i);
-            if (i < oth.digits.size())
-                res.digits.back() -= oth.digits.at(i);
-            if (res.digits.back() < 0) {
-                rest = -1;
-                res.digits.back() = 10 + res.digits.back();
-            }
-        }
-
-        if (rest)
-            res.sign = -1;
+        if (limbs.empty() || val == 0)
+            return res;
+        res.limbs.resize(limbs.size() + 1);
+        res.limbs.back() = kernels::mul1(res.limbs.data(), limbs.data(), limbs.size(), magnitudeOf(val));
+        res.sign = sign * signOf(val);
         res.trimZeros();
         return res;
     }
 
-    BigInteger BigInteger::operator/(const BigInteger &oth) const {
-        if (oth == 0)
+    BigInteger BigInteger::operator-(int64_t val) const {
+        BIGNUM_RECORD_OPERATION(Subtract, limbs.size());
+        BigInteger res;
+        res.limbs.reserve(limbs.size() + 1);
+        res = *this;
+        res.addWordInPlace(magnitudeOf(val), -signOf(val));
+        return res;
+    }
+
+
+    BigInteger BigInteger::operator/(int64_t val) const {
+        BIGNUM_RECORD_OPERATION(Divide, limbs.size());
+        if (val == 0)
             throw std::invalid_argument("Division by zero");
-        if (this->abs() < oth.abs())
-            return {};
-
-        int factor = 0;
-        BigInteger oth_copy = oth.abs();
-        auto this_abs = abs();
-        while (this_abs > oth_copy) {
-            oth_copy.multiplyByFactorOf10(1);
-            factor++;
-        }
-
-        BigInteger lower{1};
-        BigInteger upper{1};
-        lower.multiplyByFactorOf10(factor - 1);
-        upper.multiplyByFactorOf10(factor);
-        while (upper - lower > 1) {
-            auto middle = upper + lower;
-            middle.divideBy2();
-            if (middle * oth.abs() < this_abs) {
-                lower = middle;
-            } else {
-                upper = middle;
-            }
-        }
-        lower.sign = sign * oth.sign;
-        return lower;
+        BigInteger res;
+        if (limbs.empty())
+            return res;
+        res.limbs.resize(limbs.size());
+        kernels::divRem1(res.limbs.data(), limbs.data(), limbs.size(), magnitudeOf(val));
+        res.sign = sign * signOf(val);
+        res.trimZeros();
+        return res;
+    }
 
+    BigInteger BigInteger::operator&(const BigInteger &oth) const {
+        return bitwise(*this, oth, kernels::andN);
     }
 
-    BigInteger BigInteger::operator+(int64_t val) const {
-        return *this + BigInteger(val);
+    BigInteger BigInteger::operator|(const BigInteger &oth) const {
+        return bitwise(*this, oth, kernels::iorN);
     }
 
-    BigInteger BigInteger::operator*(int64_t val) const {
-        return *this * BigInteger(val);
+    BigInteger BigInteger::operator^(const BigInteger &oth) const {
+        return bitwise(*this, oth, kernels::xorN);
     }
 
-    BigInteger BigInteger::operator-(int64_t val) const {
-        return *this - BigInteger(val);
+    BigInteger BigInteger::operator&(int64_t val) const {
+        return *this & BigInteger(val);
+    }
+
+    BigInteger BigInteger::operator|(int64_t val) const {
+        return *this | BigInteger(val);
     }
 
+    BigInteger BigInteger::operator^(int64_t val) const {
+        return *this ^ BigInteger(val);
+    }
 
-    BigInteger BigInteger::operator/(int64_t val) const {
-        return *this / BigInteger(val);
+    BigInteger BigInteger::operator~() const {
+        BIGNUM_RECORD_OPERATION(Bitwise, limbs.size());
+        BigInteger res = -*this;
+        res -= 1;
+        return res;
+    }
+
+    BigInteger BigInteger::operator<<(size_t shift) const {
+        BigInteger res;
+        res.shiftLeftFrom(*this, shift);
+        return res;
+    }
+
+    BigInteger BigInteger::operator>>(size_t shift) const {
+        BigInteger res;
+        res.shiftRightFrom(*this, shift, true);
+        return res;
+    }
+
+    size_t BigInteger::bitLength() const {
+        if (limbs.empty())
+            return 0;
+        return limbs.size() * kernels::LIMB_BITS - kernels::countLeadingZeros(limbs.back());
+    }
+
+    bool BigInteger::testBit(size_t n) const {
+        size_t word = n / kernels::LIMB_BITS;
+        bool magnitudeBit = word < limbs.size() && (limbs[word] >> (n % kernels::LIMB_BITS) & 1);
+        if (sign > 0)
+            return magnitudeBit;
+
+        // in ~(m - 1) the bits of m below its lowest set bit stay clear, that bit stays set and the
+        // ones above it flip
+        size_t low = 0;
+        while (limbs[low] == 0)
+            low++;
+        size_t lowestBit = low * kernels::LIMB_BITS + kernels::countTrailingZeros(limbs[low]);
+        if (n <= lowestBit)
+            return n == lowestBit;
+        return !magnitudeBit;
+    }
+
+    size_t BigInteger::popcount() const {
+        return kernels::popcount(limbs.data(), limbs.size());
     }
 
     BigInteger BigInteger::abs() const {
         BigInteger res;
-        res.digits = digits;
+        res.limbs = limbs;
+        return res;
+    }
+
+    BigInteger BigInteger::isqrt() const {
+        return iroot(2);
+    }
+
+    BigInteger BigInteger::iroot(unsigned n) const {
+        BIGNUM_RECORD_OPERATION(Root, limbs.size());
+        if (n == 0)
+            throw std::invalid_argument("Zeroth root");
+        if (sign < 0 && n % 2 == 0)
+            throw SignException("Even root of negative value");
+
+        auto root = kernels::root(limbs.data(), limbs.size(), n);
+        BigInteger res;
+        res.limbs.assign(root.data(), root.data() + root.size());
+        res.sign = sign;
+        res.trimZeros();
         return res;
     }
 
+    bool BigInteger::isPerfectSquare() const {
+        BIGNUM_RECORD_OPERATION(Root, limbs.size());
+        return sign > 0 && kernels::isSquare(limbs.data(), limbs.size());
+    }
+
+    bool BigInteger::isPerfectPower() const {
+        BIGNUM_RECORD_OPERATION(Root, limbs.size());
+        // a negative value can only be an odd power of a negative base
+        return kernels::isPower(limbs.data(), limbs.size(), sign < 0);
+    }
+
     BigInteger &BigInteger::operator+=(const BigInteger &oth) {
-        *this = *this + oth;
+        BIGNUM_RECORD_OPERATION(Add, std::max(limbs.size(), oth.limbs.size()));
+        addInPlace(oth, oth.sign);
         return *this;
     }
 
     BigInteger &BigInteger::operator-=(const BigInteger &oth) {
-        *this = *this - oth;
+        BIGNUM_RECORD_OPERATION(Subtract, std::max(limbs.size(), oth.limbs.size()));
+        addInPlace(oth, -oth.sign);
         return *this;
     }
 
     BigInteger &BigInteger::operator*=(const BigInteger &oth) {
-        *this = *this * oth;
+        BIGNUM_RECORD_OPERATION(Multiply, std::max(limbs.size(), oth.limbs.size()));
+        if (oth.limbs.size() == 1 && this != &oth) {
+            multiplyByLimbInPlace(oth.limbs[0]);
+            sign *= oth.sign;
+            trimZeros();
+        } else {
+            *this = *this * oth;
+        }
         return *this;
     }
 
     BigInteger &BigInteger::operator/=(const BigInteger &oth) {
-        *this = *this / oth;
+        BIGNUM_RECORD_OPERATION(Divide, limbs.size());
+        if (oth.limbs.size() == 1 && this != &oth)
+            divideByLimbInPlace(oth.limbs[0], oth.sign, false);
+        else
+            *this = *this / oth;
         return *this;
     }
 
     BigInteger &BigInteger::operator+=(int64_t val) {
-        *this = *this + val;
+        BIGNUM_RECORD_OPERATION(Add, limbs.size());
+        addWordInPlace(magnitudeOf(val), signOf(val));
         return *this;
     }
 
     BigInteger &BigInteger::operator-=(int64_t val) {
-        *this = *this - val;
+        BIGNUM_RECORD_OPERATION(Subtract, limbs.size());
+        addWordInPlace(magnitudeOf(val), -signOf(val));
         return *this;
     }
 
     BigInteger &BigInteger::operator*=(int64_t val) {
-        *this = *this * val;
+        BIGNUM_RECORD_OPERATION(Multiply, limbs.size());
+        multiplyByLimbInPlace(magnitudeOf(val));
+        sign *= signOf(val);
+        trimZeros();
         return *this;
     }
 
     BigInteger &BigInteger::operator/=(int64_t val) {
-        *this = *this / val;
+        BIGNUM_RECORD_OPERATION(Divide, limbs.size());
+        if (val == 0)
+            throw std::invalid_argument("Division by zero");
+        divideByLimbInPlace(magnitudeOf(val), signOf(val), false);
+        return *this;
+    }
+
+    BigInteger &BigInteger::operator&=(const BigInteger &oth) {
+        return *this = *this & oth;
+    }
+
+    BigInteger &BigInteger::operator|=(const BigInteger &oth) {
+        return *this = *this | oth;
+    }
+
+    BigInteger &BigInteger::operator^=(const BigInteger &oth) {
+        return *this = *this ^ oth;
+    }
+
+    BigInteger &BigInteger::operator&=(int64_t val) {
+        return *this &= BigInteger(val);
+    }
+
+    BigInteger &BigInteger::operator|=(int64_t val) {
+        return *this |= BigInteger(val);
+    }
+
+    BigInteger &BigInteger::operator^=(int64_t val) {
+        return *this ^= BigInteger(val);
+    }
+
+    BigInteger &BigInteger::operator<<=(size_t shift) {
+        shiftLeftFrom(*this, shift);
+        return *this;
+    }
+
+    BigInteger &BigInteger::operator>>=(size_t shift) {
+        shiftRightFrom(*this, shift, true);
         return *this;
     }
 
     BigInteger operator+(int64_t val, const BigInteger &bi) {
-        return BigInteger(val) + bi;
+        return bi + val;
     }
 
     BigInteger operator-(int64_t val, const BigInteger &bi) {
-        return BigInteger(val) - bi;
+        BIGNUM_RECORD_OPERATION(Subtract, bi.limbs.size());
+        // val - bi = -bi + val
+        BigInteger res;
+        res.limbs.reserve(bi.limbs.size() + 1);
+        res = bi;
+        res.sign = -res.sign;
+        res.trimZeros();
+        res.addWordInPlace(magnitudeOf(val), signOf(val));
+        return res;
     }
 
     BigInteger operator*(int64_t val, const BigInteger &bi) {
-        return BigInteger(val) * bi;
+        return bi * val;
     }
 
     BigInteger operator/(int64_t val, const BigInteger &bi) {
-        return BigInteger(val) / bi;
+        BIGNUM_RECORD_OPERATION(Divide, bi.limbs.size());
+        if (bi.limbs.empty())
+            throw std::invalid_argument("Division by zero");
+        // a divisor of more than one limb exceeds any int64_t
+        if (bi.limbs.size() > 1)
+            return BigInteger();
+        return BigInteger::fromMagnitude(magnitudeOf(val) / bi.limbs[0], signOf(val) * bi.sign);
+    }
+
+    BigInteger operator+(BigInteger &&a, const BigInteger &b) {
+        a += b;
+        return std::move(a);
+    }
+
+    BigInteger operator+(const BigInteger &a, BigInteger &&b) {
+        b += a;
+        return std::move(b);
+    }
+
+    BigInteger operator+(BigInteger &&a, BigInteger &&b) {
+        // keep whichever buffer is larger
+        if (b.limbs.capacity() > a.limbs.capacity())
+            return std::move(b) + a;
+        return std::move(a) + b;
+    }
+
+    BigInteger operator-(BigInteger &&a, const BigInteger &b) {
+        a -= b;
+        return std::move(a);
+    }
+
+    BigInteger operator-(const BigInteger &a, BigInteger &&b) {
+        // a - b = -(b - a)
+        b -= a;
+        b.sign = -b.sign;
+        b.trimZeros();
+        return std::move(b);
+    }
+
+    BigInteger operator-(BigInteger &&a, BigInteger &&b) {
+        if (b.limbs.capacity() > a.limbs.capacity())
+            return a - std::move(b);
+        return std::move(a) - b;
+    }
+
+    BigInteger operator*(BigInteger &&a, const BigInteger &b) {
+        a *= b;
+        return std::move(a);
+    }
+
+    BigInteger operator*(const BigInteger &a, BigInteger &&b) {
+        b *= a;
+        return std::move(b);
+    }
+
+    BigInteger operator*(BigInteger &&a, BigInteger &&b) {
+        return std::move(a) * b;
+    }
+
+    BigInteger operator+(BigInteger &&a, int64_t val) {
+        a += val;
+        return std::move(a);
+    }
+
+    BigInteger operator-(BigInteger &&a, int64_t val) {
+        a -= val;
+        return std::move(a);
+    }
+
+    BigInteger operator*(BigInteger &&a, int64_t val) {
+        a *= val;
+        return std::move(a);
     }
 
     double BigInteger::realDivide(uint64_t val) const {
-        return realDivide(BigInteger(val));
+        return realDivide(BigInteger::from(val));
     }
 
     double BigInteger::realDivide(const BigInteger &oth) const {
         if (oth == 0)
             throw std::invalid_argument("Division by zero");
-        return toDouble() / oth.toDouble();
+        if (limbs.empty())
+            return 0;
+        // both top 64 bits are exact in a long double and the exponents are applied after dividing
+        size_t shift = bitLength() > 64 ? bitLength() - 64 : 0;
+        size_t othShift = oth.bitLength() > 64 ? oth.bitLength() - 64 : 0;
+        long double quotient = static_cast<long double>(bitsAt(limbs, shift)) / bitsAt(oth.limbs, othShift);
+        int64_t exponent = static_cast<int64_t>(shift) - static_cast<int64_t>(othShift);
+
+        // the estimate is within a few units of its last place, which only matters when the 11 bits
+        // below the double's last place are close to a halfway pattern
+        int estimateExponent;
+        auto significand = static_cast<uint64_t>(std::ldexp(std::frexp(quotient, &estimateExponent), 64));
+        uint64_t belowDouble = significand & 0x7ff;
+        // floor(log2 |quotient|), give or take one for the rounding of the estimate
+        int64_t topExponent = estimateExponent + exponent - 1;
+        // below half the smallest subnormal everything rounds to zero
+        if (topExponent < -1080)
+            return sign == oth.sign ? 0.0 : -0.0;
+        // a subnormal result has fewer than 53 bits, so its last place is not the one checked above
+        bool subnormal = topExponent < -1021;
+        double res;
+        if (subnormal || (belowDouble + 16 >= 0x400 && belowDouble <= 0x400 + 16)) {
+            // exact integer quotient of 65 or 66 bits with the remainder as a sticky bit; a subnormal one
+            // is taken in units of 2^-1076 instead, two bits below the last place of any subnormal
+            int64_t scale = subnormal ? 1076 : 65 + static_cast<int64_t>(oth.bitLength()) -
+                                               static_cast<int64_t>(bitLength());
+            BigInteger numerator = abs(), denominator = oth.abs();
+            if (scale > 0)
+                numerator <<= static_cast<size_t>(scale);
+            else
+                denominator <<= static_cast<size_t>(-scale);
+            auto qr = numerator.divmod(denominator);
+            bool sticky = !qr.second.limbs.empty();
+            if (subnormal && qr.first.bitLength() <= 55) {
+                // round once to a multiple of 2^-1074, ties to even; 2^53 * 2^-1074 is still exact
+                uint64_t bits = qr.first.limbs.empty() ? 0 : qr.first.limbs[0];
+                uint64_t units = bits >> 2, below = bits & 3;
+                if (below > 2 || (below == 2 && (sticky || (units & 1))))
+                    units++;
+                res = std::ldexp(static_cast<double>(units), -1074);
+            } else {
+                if (sticky)
+                    qr.first.limbs[0] |= 1;
+                res = std::ldexp(qr.first.toDouble(), clampExponent(-scale));
+            }
+        } else {
+            res = static_cast<double>(std::ldexp(quotient, clampExponent(exponent)));
+        }
+        return sign == oth.sign ? res : -res;
     }
 
     BigInteger BigInteger::operator-() const {
         BigInteger res = *this;
-        res.sign = sign > 0 ? -1 : 1;
+        res.sign = -sign;
+        res.trimZeros();
         return res;
     }
 
     void BigInteger::trimZeros() {
-        for (auto it = digits.rbegin(); it != digits.rend(); it++) {
-            if (*it != 0) {
-                break;
-            }
-            digits.pop_back();
+        limbs.resize(kernels::normalizedSize(limbs.data(), limbs.size()));
+        if (limbs.empty())
+            sign = 1;
+    }
+
+    BigInteger BigInteger::fromMagnitude(uint64_t magnitude, int sign) {
+        BigInteger res;
+        if (magnitude) {
+            res.limbs.push_back(magnitude);
+            res.sign = sign;
+        }
+        return res;
+    }
+
+    int BigInteger::compareTo(uint64_t magnitude, int valSign) const {
+        BIGNUM_RECORD_OPERATION(Compare, limbs.size());
+        if (magnitude == 0)
+            return limbs.empty() ? 0 : sign;
+        if (sign != valSign)
+            return sign;
+        if (limbs.size() != 1)
+            return limbs.empty() ? -sign : sign;
+        if (limbs[0] == magnitude)
+            return 0;
+        return limbs[0] > magnitude ? sign : -sign;
+    }
+
+    void BigInteger::addWordInPlace(uint64_t magnitude, int valSign) {
+        if (magnitude == 0)
+            return;
+        if (limbs.empty()) {
+            limbs.push_back(magnitude);
+            sign = valSign;
+        } else if (sign == valSign) {
+            uint64_t carry = kernels::add1(limbs.data(), limbs.data(), limbs.size(), magnitude);
+            if (carry)
+                limbs.push_back(carry);
+        } else if (limbs.size() > 1 || limbs[0] >= magnitude) {
+            kernels::sub1(limbs.data(), limbs.data(), limbs.size(), magnitude);
+            trimZeros();
+        } else {
+            limbs[0] = magnitude - limbs[0];
+            sign = valSign;
+        }
+    }
+
+    void BigInteger::addInPlace(const BigInteger &oth, int othSign) {
+        size_t n = limbs.size();
+        size_t m = oth.limbs.size();
+        if (m == 0)
+            return;
+        if (sign == othSign || n == 0) {
+            if (n < m)
+                limbs.resize(m);
+            uint64_t carry = kernels::add(limbs.data(), limbs.data(), limbs.size(), oth.limbs.data(), m);
+            if (carry)
+                limbs.push_back(carry);
+            sign = othSign;
+        } else if (compareMagnitudes(limbs, oth.limbs) >= 0) {
+            kernels::sub(limbs.data(), limbs.data(), n, oth.limbs.data(), m);
+        } else {
+            // |oth| - |this|, written over this
+            limbs.resize(m);
+            kernels::sub(limbs.data(), oth.limbs.data(), m, limbs.data(), n);
+            sign = othSign;
+        }
+        trimZeros();
+    }
+
+    void BigInteger::multiplyByLimbInPlace(uint64_t limb) {
+        uint64_t carry = kernels::mul1(limbs.data(), limbs.data(), limbs.size(), limb);
+        if (carry)
+            limbs.push_back(carry);
+    }
+
+    void BigInteger::divideByLimbInPlace(uint64_t limb, int divisorSign, bool keepRemainder) {
+        uint64_t remainder = kernels::divRem1(limbs.data(), limbs.data(), limbs.size(), limb);
+        if (keepRemainder) {
+            limbs.clear();
+            limbs.push_back(remainder);
+        } else {
+            sign *= divisorSign;
         }
+        trimZeros();
     }
 
-    // insert leading zeros to vector of digits
-    void BigInteger::multiplyByFactorOf10(int factor) {
-        std::vector<int8_t> zeros(factor, 0);
-        digits.insert(digits.begin(), zeros.begin(), zeros.end());
+    void BigInteger::shiftLeftFrom(const BigInteger &src, size_t shift) {
+        BIGNUM_RECORD_OPERATION(Shift, src.limbs.size());
+        size_t n = src.limbs.size();
+        if (n == 0) {
+            limbs.clear();
+            sign = 1;
+            return;
+        }
+
+        size_t words = shift / kernels::LIMB_BITS;
+        unsigned bits = shift % kernels::LIMB_BITS;
+        // src is only read after resizing, so it may be *this
+        limbs.resize(n + words + 1);
+        uint64_t *r = limbs.data();
+        const uint64_t *a = src.limbs.data();
+        if (bits) {
+            r[n + words] = kernels::lshift(r + words, a, n, bits);
+        } else {
+            std::copy_backward(a, a + n, r + words + n);
+            r[n + words] = 0;
+        }
+        std::fill(r, r + words, 0);
+        sign = src.sign;
         trimZeros();
     }
 
-    void BigInteger::divideBy2() {
-        for (auto it = digits.rbegin(); it != digits.rend(); it++) {
-            if (*it % 2 == 1) {
-                auto next = it;
-                next++;
-                if (next != digits.rend())
-                    *next += 10;
+    void BigInteger::shiftRightFrom(const BigInteger &src, size_t shift, bool floor) {
+        BIGNUM_RECORD_OPERATION(Shift, src.limbs.size());
+        size_t n = src.limbs.size();
+        size_t words = shift / kernels::LIMB_BITS;
+        unsigned bits = shift % kernels::LIMB_BITS;
+        bool roundAway = floor && src.sign < 0;
+        if (words >= n) {
+            // every bit is shifted out, leaving -1 for a negative value rounded down
+            limbs.clear();
+            sign = 1;
+            if (roundAway && n > 0) {
+                limbs.push_back(1);
+                sign = -1;
             }
-            *it /= 2;
+            return;
         }
+
+        size_t m = n - words;
+        bool lost = roundAway && kernels::normalizedSize(src.limbs.data(), words) != 0;
+        if (this != &src)
+            limbs.resize(m);
+        uint64_t *r = limbs.data();
+        const uint64_t *a = src.limbs.data() + words;
+        if (bits)
+            lost |= kernels::rshift(r, a, m, bits) != 0;
+        else
+            std::copy(a, a + m, r);
+        limbs.resize(m);
+        sign = src.sign;
+        if (roundAway && lost && kernels::add1(r, r, m, 1))
+            limbs.push_back(1);
         trimZeros();
     }
 
-    BigInteger BigInteger::operator%(const BigInteger &oth) const {
-        BigInteger res = *this - (oth * (*this / oth));
-        if (sign > 0)
+    BigInteger BigInteger::bitwise(const BigInteger &a, const BigInteger &b,
+                                   void (*op)(uint64_t *, const uint64_t *, const uint64_t *, size_t)) {
+        BIGNUM_RECORD_OPERATION(Bitwise, std::max(a.limbs.size(), b.limbs.size()));
+        size_t n = std::max(a.limbs.size(), b.limbs.size());
+        BigInteger res;
+        if (n == 0)
+            return res;
+
+        if (a.sign > 0 && b.sign > 0) {
+            // plain magnitudes, the shorter one padded with zeros
+            if (op == kernels::andN)
+                n = std::min(a.limbs.size(), b.limbs.size());
+            const auto &longer = a.limbs.size() >= b.limbs.size() ? a.limbs : b.limbs;
+            const auto &shorter = a.limbs.size() >= b.limbs.size() ? b.limbs : a.limbs;
+            size_t common = std::min(n, shorter.size());
+            res.limbs.resize(n);
+            op(res.limbs.data(), longer.data(), shorter.data(), common);
+            std::copy(longer.data() + common, longer.data() + n, res.limbs.data() + common);
+            res.trimZeros();
             return res;
-        return -(res.abs() % oth);
+        }
+
+        // one more limb than either operand holds the sign bit
+        n++;
+        res.limbs.resize(n);
+        auto other = kernels::makeScratch(n);
+        toTwosComplement(a.limbs, a.sign, res.limbs.data(), n);
+        toTwosComplement(b.limbs, b.sign, other.data(), n);
+        op(res.limbs.data(), res.limbs.data(), other.data(), n);
+        if (res.limbs.back() >> (kernels::LIMB_BITS - 1)) {
+            // negative result, its magnitude is ~r + 1
+            kernels::comN(res.limbs.data(), res.limbs.data(), n);
+            kernels::add1(res.limbs.data(), res.limbs.data(), n, 1);
+            res.sign = -1;
+        }
+        res.trimZeros();
+        return res;
+    }
+
+    BigInteger BigInteger::productTree(std::vector<BigInteger> &factors) {
+        if (factors.empty())
+            return BigInteger(1);
+        // neighbours are multiplied level by level, each level halving the number of factors
+        for (size_t step = 1; step < factors.size(); step *= 2) {
+            for (size_t i = 0; i + step < factors.size(); i += 2 * step) {
+                factors[i] *= factors[i + step];
+                factors[i + step] = BigInteger();
+            }
+        }
+        return std::move(factors[0]);
+    }
+
+    BigInteger BigInteger::addMagnitudes(const BigInteger &a, const BigInteger &b, int sign) {
+        const auto &longer = a.limbs.size() >= b.limbs.size() ? a.limbs : b.limbs;
+        const auto &shorter = a.limbs.size() >= b.limbs.size() ? b.limbs : a.limbs;
+        BigInteger res;
+        res.limbs.resize(longer.size() + 1);
+        res.limbs.back() = kernels::add(res.limbs.data(), longer.data(), longer.size(),
+                                        shorter.data(), shorter.size());
+        res.sign = sign;
+        res.trimZeros();
+        return res;
+    }
+
+    // requires |a| >= |b|
+    BigInteger BigInteger::subtractMagnitudes(const BigInteger &a, const BigInteger &b, int sign) {
+        BigInteger res;
+        res.limbs.resize(a.limbs.size());
+        kernels::sub(res.limbs.data(), a.limbs.data(), a.limbs.size(), b.limbs.data(), b.limbs.size());
+        res.sign = sign;
+        res.trimZeros();
+        return res;
+    }
+
+    std::pair<BigInteger, BigInteger> BigInteger::divmod(const BigInteger &oth) const {
+        BIGNUM_RECORD_OPERATION(DivMod, limbs.size());
+        if (oth.limbs.empty())
+            throw std::invalid_argument("Division by zero");
+
+        BigInteger q;
+        BigInteger r;
+        if (compareMagnitudes(limbs, oth.limbs) < 0) {
+            r = *this;
+            return {std::move(q), std::move(r)};
+        }
+
+        if (oth.popcount() == 1) {
+            // a power of two divides by shifting and keeps the low bits as the remainder
+            size_t shift = oth.bitLength() - 1;
+            size_t words = shift / kernels::LIMB_BITS;
+            r.limbs.assign(limbs.data(), limbs.data() + words + 1);
+            r.limbs.back() &= (uint64_t(1) << (shift % kernels::LIMB_BITS)) - 1;
+            r.sign = sign;
+            r.trimZeros();
+            q.shiftRightFrom(*this, shift, false);
+            q.sign *= oth.sign;
+            q.trimZeros();
+            return {std::move(q), std::move(r)};
+        }
+
+        q.limbs.resize(limbs.size() - oth.limbs.size() + 1);
+        r.limbs.resize(oth.limbs.size());
+        kernels::divRem(q.limbs.data(), r.limbs.data(), limbs.data(), limbs.size(),
+                        oth.limbs.data(), oth.limbs.size());
+        q.sign = sign * oth.sign;
+        q.trimZeros();
+        r.sign = sign;
+        r.trimZeros();
+        return {std::move(q), std::move(r)};
+    }
+
+    BigInteger BigInteger::operator%(const BigInteger &oth) const {
+        BIGNUM_RECORD_OPERATION(Modulo, limbs.size());
+        return divmod(oth).second;
     }
 
     BigInteger BigInteger::operator%(int64_t val) const {
-        return *this % BigInteger(val);
+        BIGNUM_RECORD_OPERATION(Modulo, limbs.size());
+        if (val == 0)
+            throw std::invalid_argument("Division by zero");
+        return fromMagnitude(kernels::mod1(limbs.data(), limbs.size(), magnitudeOf(val)), sign);
     }
 
     BigInteger &BigInteger::operator%=(int64_t val) {
-        *this = *this % BigInteger(val);
+        BIGNUM_RECORD_OPERATION(Modulo, limbs.size());
+        if (val == 0)
+            throw std::invalid_argument("Division by zero");
+        divideByLimbInPlace(magnitudeOf(val), signOf(val), true);
         return *this;
     }
 
     BigInteger &BigInteger::operator%=(const BigInteger &oth) {
-        *this = *this % oth;
+        BIGNUM_RECORD_OPERATION(Modulo, limbs.size());
+        if (oth.limbs.size() == 1 && this != &oth)
+            divideByLimbInPlace(oth.limbs[0], oth.sign, true);
+        else
+            *this = *this % oth;
         return *this;
     }
 
     BigInteger operator%(int64_t val, const BigInteger &bi) {
-        return BigInteger(val) % bi;
+        BIGNUM_RECORD_OPERATION(Modulo, bi.limbs.size());
+        if (bi.limbs.empty())
+            throw std::invalid_argument("Division by zero");
+        if (bi.limbs.size() > 1)
+            return BigInteger(val);
+        return BigInteger::fromMagnitude(magnitudeOf(val) % bi.limbs[0], signOf(val));
     }
 
-    double BigInteger::toDouble() const {
-        double res = 0;
-        double tens = 1;
-        for (auto d : digits) {
-            res += (d * tens);
-            tens *= 10;
-        }
-        return sign * res;
-    }
+    // instantiated for the fundamental types, so every fixed-width alias is covered whichever type it names
+    template BigInteger BigInteger::from(char val);
+
+    template BigInteger BigInteger::from(signed char val);
+
+    template BigInteger BigInteger::from(unsigned char val);
+
+    template BigInteger BigInteger::from(short val);
+
+    template BigInteger BigInteger::from(unsigned short val);
+
+    template BigInteger BigInteger::from(int val);
+
+    template BigInteger BigInteger::from(unsigned val);
+
+    template BigInteger BigInteger::from(long val);
+
+    template BigInteger BigInteger::from(unsigned long val);
+
+    template BigInteger BigInteger::from(long long val);
+
+    template BigInteger BigInteger::from(unsigned long long val);
+
+    template BigInteger BigInteger::from(__int128 val);
+
+    template BigInteger BigInteger::from(unsigned __int128 val);
 
+    template BigInteger BigInteger::from(float val);
 
-    template BigInteger BigInteger::from(uint64_t val);
+    template BigInteger BigInteger::from(double val);
 
-    template BigInteger BigInteger::from(int64_t val);
+    template BigInteger BigInteger::from(long double val);
 
-    template BigInteger BigInteger::from(uint32_t val);
 
-    template BigInteger BigInteger::from(int32_t val);
+    template char BigInteger::value<char>() const;
 
-    template BigInteger BigInteger::from(uint16_t val);
+    template signed char BigInteger::value<signed char>() const;
 
-    template BigInteger BigInteger::from(int16_t val);
+    template unsigned char BigInteger::value<unsigned char>() const;
 
-    template BigInteger BigInteger::from(uint8_t val);
+    template short BigInteger::value<short>() const;
 
-    template BigInteger BigInteger::from(int8_t val);
+    template unsigned short BigInteger::value<unsigned short>() const;
 
+    template int BigInteger::value<int>() const;
 
-    template uint64_t BigInteger::value<uint64_t>();
+    template unsigned BigInteger::value<unsigned>() const;
 
-    template int64_t BigInteger::value<int64_t>();
+    template long BigInteger::value<long>() const;
 
-    template int32_t BigInteger::value<int32_t>();
+    template unsigned long BigInteger::value<unsigned long>() const;
 
-    template uint32_t BigInteger::value<uint32_t>();
+    template long long BigInteger::value<long long>() const;
 
-    template uint16_t BigInteger::value<uint16_t>();
+    template unsigned long long BigInteger::value<unsigned long long>() const;
 
-    template int16_t BigInteger::value<int16_t>();
+    template __int128 BigInteger::value<__int128>() const;
 
-    template int8_t BigInteger::value<int8_t>();
+    template unsigned __int128 BigInteger::value<unsigned __int128>() const;
 
-    template uint8_t BigInteger::value<uint8_t>();
+    template bool BigInteger::fitsIn<char>() const noexcept;
+
+    template bool BigInteger::fitsIn<signed char>() const noexcept;
+
+    template bool BigInteger::fitsIn<unsigned char>() const noexcept;
+
+    template bool BigInteger::fitsIn<short>() const noexcept;
+
+    template bool BigInteger::fitsIn<unsigned short>() const noexcept;
+
+    template bool BigInteger::fitsIn<int>() const noexcept;
+
+    template bool BigInteger::fitsIn<unsigned>() const noexcept;
+
+    template bool BigInteger::fitsIn<long>() const noexcept;
+
+    template bool BigInteger::fitsIn<unsigned long>() const noexcept;
+
+    template bool BigInteger::fitsIn<long long>() const noexcept;
+
+    template bool BigInteger::fitsIn<unsigned long long>() const noexcept;
+
+    template bool BigInteger::fitsIn<__int128>() const noexcept;
+
+    template bool BigInteger::fitsIn<unsigned __int128>() const noexcept;
 
 
     BigInteger::OverflowException::OverflowException(char const *const message) noexcept : invalid_argument(message) {}
@@ -436,4 +1367,132 @@ namespace BigNum {
     char const *BigInteger::SignException::what() const noexcept {
         return logic_error::what();
     }
+
+    BigInteger powMod(const BigInteger &base, const BigInteger &exp, const BigInteger &mod) {
+        BIGNUM_RECORD_OPERATION(PowMod, mod.limbs.size());
+        if (mod.limbs.empty())
+            throw std::invalid_argument("Division by zero");
+        if (exp.sign < 0)
+            throw BigInteger::SignException("Negative exponent");
+
+        BigInteger modulus = mod.abs();
+        BigInteger res;
+        if (modulus == 1)
+            return res;
+        if (exp.limbs.empty())
+            return BigInteger(1);
+        BigInteger reduced = base % modulus;
+        if (reduced.sign < 0)
+            reduced += modulus;
+        if (reduced.limbs.empty())
+            return res;
+
+        res.limbs.resize(modulus.limbs.size());
+        kernels::powMod(res.limbs.data(), reduced.limbs.data(), reduced.limbs.size(), exp.limbs.data(),
+                        exp.limbs.size(), modulus.limbs.data(), modulus.limbs.size());
+        res.trimZeros();
+        return res;
+    }
+
+    BigInteger gcd(const BigInteger &a, const BigInteger &b) {
+        BIGNUM_RECORD_OPERATION(Gcd, std::max(a.limbs.size(), b.limbs.size()));
+        if (a.limbs.empty())
+            return b.abs();
+        if (b.limbs.empty())
+            return a.abs();
+        auto g = kernels::gcd(a.limbs.data(), a.limbs.size(), b.limbs.data(), b.limbs.size());
+        BigInteger res;
+        res.limbs.assign(g.data(), g.data() + g.size());
+        return res;
+    }
+
+    std::tuple<BigInteger, BigInteger, BigInteger> extendedGcd(const BigInteger &a, const BigInteger &b) {
+        BIGNUM_RECORD_OPERATION(Gcd, std::max(a.limbs.size(), b.limbs.size()));
+        if (b.limbs.empty())
+            return {a.abs(), BigInteger(a.limbs.empty() ? 0 : a.sign), BigInteger(0)};
+        if (a.limbs.empty())
+            return {b.abs(), BigInteger(0), BigInteger(b.sign)};
+
+        kernels::Scratch cofactor = kernels::makeScratch();
+        auto g = kernels::gcdExt(a.limbs.data(), a.limbs.size(), b.limbs.data(), b.limbs.size(), cofactor);
+        BigInteger res, x;
+        res.limbs.assign(g.data(), g.data() + g.size());
+        x.limbs.assign(cofactor.data(), cofactor.data() + cofactor.size());
+        // |a| * x + |b| * y = g, with the exact division giving y
+        BigInteger y = (res - x * a.abs()) / b.abs();
+        x.sign = a.sign;
+        x.trimZeros();
+        y *= b.sign;
+        return {std::move(res), std::move(x), std::move(y)};
+    }
+
+    BigInteger modInverse(const BigInteger &a, const BigInteger &mod) {
+        BIGNUM_RECORD_OPERATION(Gcd, mod.limbs.size());
+        if (mod.limbs.empty())
+            throw std::invalid_argument("Division by zero");
+
+        BigInteger modulus = mod.abs();
+        BigInteger reduced = a % modulus;
+        if (reduced.sign < 0)
+            reduced += modulus;
+        if (modulus == 1)
+            return BigInteger();
+        if (reduced.limbs.empty())
+            throw std::invalid_argument("Value is not invertible");
+
+        kernels::Scratch cofactor = kernels::makeScratch();
+        auto g = kernels::gcdExt(reduced.limbs.data(), reduced.limbs.size(), modulus.limbs.data(),
+                                 modulus.limbs.size(), cofactor);
+        if (g.size() != 1 || g[0] != 1)
+            throw std::invalid_argument("Value is not invertible");
+        BigInteger res;
+        res.limbs.assign(cofactor.data(), cofactor.data() + cofactor.size());
+        return res;
+    }
+
+    BigInteger factorial(uint64_t n) {
+        // the power of two is a shift instead of squarings
+        auto primes = kernels::primesUpTo(n);
+        BigInteger res = primePowerProduct(primes, [n](uint64_t p) {
+            return p == 2 ? 0 : factorialExponent(n, p);
+        });
+        return res << factorialExponent(n, 2);
+    }
+
+    BigInteger binomial(uint64_t n, uint64_t k) {
+        if (k > n)
+            return BigInteger();
+        k = std::min(k, n - k);
+        if (k == 0)
+            return BigInteger(1);
+
+        if (n / k >= BINOMIAL_FALLING_RATIO) {
+            WordProduct falling;
+            for (uint64_t i = n - k + 1; i <= n && i != 0; i++)
+                falling.multiply(i);
+            return falling.result() / factorial(k);
+        }
+
+        // Kummer: the exponent of p in n! / (k! (n - k)!)
+        auto primes = kernels::primesUpTo(n);
+        auto exponent = [n, k](uint64_t p) {
+            return factorialExponent(n, p) - factorialExponent(k, p) - factorialExponent(n - k, p);
+        };
+        BigInteger res = primePowerProduct(primes, [&exponent](uint64_t p) {
+            return p == 2 ? 0 : exponent(p);
+        });
+        return res << exponent(2);
+    }
+
+    BigInteger primorial(uint64_t n) {
+        WordProduct primes;
+        for (uint64_t p : kernels::primesUpTo(n))
+            primes.multiply(p);
+        return primes.result();
+    }
+
+    BigInteger multiply(const BigInteger &a, const BigInteger &b, const ExecutionPolicy &policy) {
+        ExecutionScope scope(policy);
+        return a * b;
+    }
 }
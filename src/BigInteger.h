@@ -1,14 +1,30 @@
 #pragma once
 
-#include <vector>
+#include <charconv>
 #include <cstdint>
+#include <iosfwd>
+#include <iterator>
 #include <stdexcept>
-#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "ExecutionPolicy.h"
+#include "LimbResources.h"
+#include "LimbStorage.h"
 
 namespace BigNum {
+    enum class Overflow;
+
+    template<size_t Bits, bool Signed, Overflow Policy>
+    class BasicFixedInt;
+
     class BigInteger {
     public:
-        explicit BigInteger(std::string str);
+        // decimal number with an optional leading '-' and surrounding whitespace, throws
+        // std::invalid_argument for anything else; from_chars parses without exceptions
+        explicit BigInteger(std::string_view str);
 
         class OverflowException : public std::invalid_argument {
         public:
@@ -28,6 +44,10 @@ namespace BigNum {
 
         BigInteger(const BigInteger &oth) = default;
 
+        // copy whose limbs are allocated from the given resource, e.g. to keep a result computed
+        // inside a ResourceScope after its arena is released
+        BigInteger(const BigInteger &oth, std::pmr::memory_resource *resource);
+
         BigInteger(BigInteger &&oth) = default;
 
         BigInteger &operator=(const BigInteger &oth) = default;
@@ -36,11 +56,41 @@ namespace BigNum {
 
         explicit BigInteger(int64_t val);
 
+        // value as a built-in integer type up to __int128, throwing OverflowException or SignException
+        // when it does not fit
+        template<typename T>
+        T value() const;
+
+        // whether value<T>() would succeed, without branching on the value
         template<typename T>
-        T value();
+        bool fitsIn() const noexcept;
+
+        // nearest floating-point value, ties to even, and infinity beyond the largest finite one
+        double toDouble() const;
+
+        long double toLongDouble() const;
 
         std::string toString() const;
 
+        // characters that toString and to_chars produce at most, the sign included; never more than one
+        // above the actual length
+        size_t decimalLength() const noexcept;
+
+        // compact binary form: a LEB128 varint of 2 * limbCount + (negative ? 1 : 0) followed by the
+        // limbs as little-endian 8-byte words, so zero is the single byte 0
+        size_t serializedSize() const;
+
+        // writes serializedSize() bytes to buffer and returns their number
+        size_t serialize(void *buffer) const;
+
+        void serialize(std::ostream &out) const;
+
+        // reads a value written by serialize and stores the number of bytes read in consumed; throws
+        // std::invalid_argument on truncated or non-canonical input
+        static BigInteger deserialize(const void *buffer, size_t size, size_t *consumed = nullptr);
+
+        static BigInteger deserialize(std::istream &in);
+
         bool operator>(const BigInteger &oth) const;
 
         bool operator<(const BigInteger &oth) const;
@@ -75,6 +125,10 @@ namespace BigNum {
 
         BigInteger operator%(const BigInteger &oth) const;
 
+        // quotient and remainder of a truncating division in a single pass; the quotient rounds towards
+        // zero and the remainder takes the sign of the dividend, matching operator/ and operator%
+        std::pair<BigInteger, BigInteger> divmod(const BigInteger &oth) const;
+
         BigInteger operator+(int64_t val) const;
 
         BigInteger operator-(int64_t val) const;
@@ -85,8 +139,49 @@ namespace BigNum {
 
         BigInteger operator%(int64_t val) const;
 
+        // bitwise operations act on the two's complement representation with infinitely many sign bits,
+        // so ~x == -x - 1 and a negative value has all high bits set
+        BigInteger operator&(const BigInteger &oth) const;
+
+        BigInteger operator|(const BigInteger &oth) const;
+
+        BigInteger operator^(const BigInteger &oth) const;
+
+        BigInteger operator&(int64_t val) const;
+
+        BigInteger operator|(int64_t val) const;
+
+        BigInteger operator^(int64_t val) const;
+
+        BigInteger operator~() const;
+
+        BigInteger operator<<(size_t shift) const;
+
+        // arithmetic shift, rounding towards negative infinity unlike operator/
+        BigInteger operator>>(size_t shift) const;
+
+        // number of bits of the magnitude, 0 for zero
+        size_t bitLength() const;
+
+        // bit n of the two's complement representation
+        bool testBit(size_t n) const;
+
+        // number of set bits of the magnitude
+        size_t popcount() const;
+
         BigInteger abs() const;
 
+        // floor of the square root, throws SignException for negative values
+        BigInteger isqrt() const;
+
+        // n-th root rounded towards zero; negative values have a root only for odd n
+        BigInteger iroot(unsigned n) const;
+
+        bool isPerfectSquare() const;
+
+        // whether the value is b^k for some integer b and k >= 2
+        bool isPerfectPower() const;
+
         BigInteger operator-() const;
 
         BigInteger &operator+=(const BigInteger &oth);
@@ -109,10 +204,36 @@ namespace BigNum {
 
         BigInteger &operator%=(int64_t val);
 
+        BigInteger &operator&=(const BigInteger &oth);
+
+        BigInteger &operator|=(const BigInteger &oth);
+
+        BigInteger &operator^=(const BigInteger &oth);
+
+        BigInteger &operator&=(int64_t val);
+
+        BigInteger &operator|=(int64_t val);
+
+        BigInteger &operator^=(int64_t val);
+
+        BigInteger &operator<<=(size_t shift);
+
+        BigInteger &operator>>=(size_t shift);
+
+        // quotient as a double; both operands are scaled to their top bits first, so only a quotient
+        // that is itself out of range over- or underflows
         double realDivide(uint64_t) const;
 
         double realDivide(const BigInteger &oth) const;
 
+        // parses an optional '-' and decimal digits at the start of [first, last) like std::from_chars:
+        // ptr points past the last digit, or ec is std::errc::invalid_argument and value is unchanged
+        friend std::from_chars_result from_chars(const char *first, const char *last, BigInteger &value);
+
+        // writes the decimal form to [first, last) like std::to_chars: ptr points past the last character,
+        // or ec is std::errc::value_too_large, ptr is last and the contents of the range are unspecified
+        friend std::to_chars_result to_chars(char *first, char *last, const BigInteger &value);
+
         friend BigInteger operator+(int64_t val, const BigInteger &bi);
 
         friend BigInteger operator-(int64_t val, const BigInteger &bi);
@@ -123,22 +244,148 @@ namespace BigNum {
 
         friend BigInteger operator%(int64_t val, const BigInteger &bi);
 
+        // overloads taking a temporary reuse its storage for the result
+
+        friend BigInteger operator+(BigInteger &&a, const BigInteger &b);
+
+        friend BigInteger operator+(const BigInteger &a, BigInteger &&b);
+
+        friend BigInteger operator+(BigInteger &&a, BigInteger &&b);
+
+        friend BigInteger operator-(BigInteger &&a, const BigInteger &b);
+
+        friend BigInteger operator-(const BigInteger &a, BigInteger &&b);
+
+        friend BigInteger operator-(BigInteger &&a, BigInteger &&b);
+
+        friend BigInteger operator*(BigInteger &&a, const BigInteger &b);
+
+        friend BigInteger operator*(const BigInteger &a, BigInteger &&b);
+
+        friend BigInteger operator*(BigInteger &&a, BigInteger &&b);
+
+        friend BigInteger operator+(BigInteger &&a, int64_t val);
+
+        friend BigInteger operator-(BigInteger &&a, int64_t val);
+
+        friend BigInteger operator*(BigInteger &&a, int64_t val);
+
+        // base^exp mod |mod| in [0, |mod|) for exp >= 0; a negative base is reduced to its positive residue
+        friend BigInteger powMod(const BigInteger &base, const BigInteger &exp, const BigInteger &mod);
+
+        // greatest common divisor, never negative; gcd(0, 0) = 0
+        friend BigInteger gcd(const BigInteger &a, const BigInteger &b);
+
+        // (g, x, y) with a * x + b * y = g = gcd(a, b); for non-zero a and b, |x| < |b| / g
+        friend std::tuple<BigInteger, BigInteger, BigInteger> extendedGcd(const BigInteger &a, const BigInteger &b);
+
+        // x in [0, |mod|) with a * x = 1 (mod |mod|), throws std::invalid_argument if gcd(a, mod) != 1
+        friend BigInteger modInverse(const BigInteger &a, const BigInteger &mod);
+
+        // any built-in integer type including __int128, or a finite floating-point value truncated
+        // towards zero (std::invalid_argument for infinities and NaN)
         template<typename T>
         static BigInteger from(T val);
 
+        // sum and product of a range of BigIntegers or built-in integers; the product multiplies
+        // neighbours in a balanced tree, so the multiplier sees operands of similar size instead of
+        // one growing accumulator
+        template<typename It>
+        static BigInteger sum(It first, It last);
+
+        template<typename It>
+        static BigInteger product(It first, It last);
+
+        template<typename Range>
+        static BigInteger sum(const Range &range) { return sum(std::begin(range), std::end(range)); }
+
+        template<typename Range>
+        static BigInteger product(const Range &range) { return product(std::begin(range), std::end(range)); }
+
     private:
+        friend class BigIntegerParser;
+
+        template<size_t Bits, bool Signed, Overflow Policy>
+        friend class BasicFixedInt;
+
+        friend class MappedBigIntegerArray;
+
         int sign = 1;
-        std::vector<int8_t> digits;
+        // magnitude as little-endian base 2^64 limbs, without leading zero limbs; values up to
+        // 128 bits are stored inline
+        LimbStorage limbs;
 
         void trimZeros();
 
-        void multiplyByFactorOf10(int factor);
+        int compareTo(const BigInteger &oth) const;
 
-        void divideBy2();
+        // the int64_t overloads work on the single word valSign * magnitude without a temporary BigInteger
+        int compareTo(uint64_t magnitude, int valSign) const;
 
-        double toDouble() const;
+        void addWordInPlace(uint64_t magnitude, int valSign);
+
+        static BigInteger fromMagnitude(uint64_t magnitude, int sign);
+
+        // *this += othSign * |oth| reusing the current buffer
+        void addInPlace(const BigInteger &oth, int othSign);
+
+        void multiplyByLimbInPlace(uint64_t limb);
+
+        // truncating division by a one-limb divisor, keeping either the quotient or the remainder
+        void divideByLimbInPlace(uint64_t limb, int divisorSign, bool keepRemainder);
+
+        // *this = src << shift; src may be *this
+        void shiftLeftFrom(const BigInteger &src, size_t shift);
+
+        // *this = src >> shift of the magnitude keeping the sign, rounding towards negative infinity when floor
+        // is set and towards zero otherwise; src may be *this
+        void shiftRightFrom(const BigInteger &src, size_t shift, bool floor);
+
+        // a op b on two's complement limbs, op being one of kernels::andN, iorN or xorN
+        static BigInteger bitwise(const BigInteger &a, const BigInteger &b,
+                                  void (*op)(uint64_t *, const uint64_t *, const uint64_t *, size_t));
+
+        static BigInteger addMagnitudes(const BigInteger &a, const BigInteger &b, int sign);
+
+        static BigInteger subtractMagnitudes(const BigInteger &a, const BigInteger &b, int sign);
+
+        template<typename F>
+        F toFloating() const;
+
+        static BigInteger fromFloating(long double val);
+
+        static const BigInteger &toBigInteger(const BigInteger &val) { return val; }
+
+        template<typename T>
+        static BigInteger toBigInteger(T val) { return from(val); }
+
+        // product of all factors, consuming them
+        static BigInteger productTree(std::vector<BigInteger> &factors);
     };
 
+    template<typename It>
+    BigInteger BigInteger::sum(It first, It last) {
+        BigInteger res;
+        for (; first != last; ++first)
+            res += toBigInteger(*first);
+        return res;
+    }
+
+    template<typename It>
+    BigInteger BigInteger::product(It first, It last) {
+        std::vector<BigInteger> factors;
+        for (; first != last; ++first)
+            factors.push_back(toBigInteger(*first));
+        return productTree(factors);
+    }
+
+    std::from_chars_result from_chars(const char *first, const char *last, BigInteger &value);
+
+    std::to_chars_result to_chars(char *first, char *last, const BigInteger &value);
+
+    // skips whitespace and reads a decimal number, setting failbit if there is none
+    std::istream &operator>>(std::istream &in, BigInteger &value);
+
     BigInteger operator+(int64_t val, const BigInteger &bi);
 
     BigInteger operator-(int64_t val, const BigInteger &bi);
@@ -149,4 +396,48 @@ namespace BigNum {
 
     BigInteger operator%(int64_t val, const BigInteger &bi);
 
+    BigInteger operator+(BigInteger &&a, const BigInteger &b);
+
+    BigInteger operator+(const BigInteger &a, BigInteger &&b);
+
+    BigInteger operator+(BigInteger &&a, BigInteger &&b);
+
+    BigInteger operator-(BigInteger &&a, const BigInteger &b);
+
+    BigInteger operator-(const BigInteger &a, BigInteger &&b);
+
+    BigInteger operator-(BigInteger &&a, BigInteger &&b);
+
+    BigInteger operator*(BigInteger &&a, const BigInteger &b);
+
+    BigInteger operator*(const BigInteger &a, BigInteger &&b);
+
+    BigInteger operator*(BigInteger &&a, BigInteger &&b);
+
+    BigInteger operator+(BigInteger &&a, int64_t val);
+
+    BigInteger operator-(BigInteger &&a, int64_t val);
+
+    BigInteger operator*(BigInteger &&a, int64_t val);
+
+    BigInteger powMod(const BigInteger &base, const BigInteger &exp, const BigInteger &mod);
+
+    BigInteger gcd(const BigInteger &a, const BigInteger &b);
+
+    std::tuple<BigInteger, BigInteger, BigInteger> extendedGcd(const BigInteger &a, const BigInteger &b);
+
+    BigInteger modInverse(const BigInteger &a, const BigInteger &mod);
+
+    // n! from its prime factorization, each prime's power taken by repeated squaring
+    BigInteger factorial(uint64_t n);
+
+    // n choose k, 0 for k > n
+    BigInteger binomial(uint64_t n, uint64_t k);
+
+    // product of all primes p <= n
+    BigInteger primorial(uint64_t n);
+
+    // a * b under the given policy instead of the thread's current one
+    BigInteger multiply(const BigInteger &a, const BigInteger &b, const ExecutionPolicy &policy);
+
 }
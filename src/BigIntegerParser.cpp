@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <cctype>
+#include "BigIntegerParser.h"
+#include "Instrumentation.h"
+#include "conversion.h"
+
+namespace BigNum {
+    BigIntegerParser::BigIntegerParser() = default;
+
+    const char *BigIntegerParser::feed(const char *first, const char *last) {
+        for (; first != last && state != State::Done; first++) {
+            char c = *first;
+            if (c >= '0' && c <= '9') {
+                state = State::Digits;
+                sawDigit = true;
+                // leading zeros would only waste chunks
+                if (pendingDigits == 0 && chunks.empty() && c == '0')
+                    continue;
+                pending = pending * 10 + static_cast<uint64_t>(c - '0');
+                if (++pendingDigits == kernels::DECIMAL_BASE_DIGITS) {
+                    chunks.push_back(pending);
+                    pending = 0;
+                    pendingDigits = 0;
+                }
+            } else if (state == State::Start && std::isspace(static_cast<unsigned char>(c))) {
+                continue;
+            } else if (state == State::Start && c == '-') {
+                state = State::Sign;
+                negative = true;
+            } else {
+                state = State::Done;
+                break;
+            }
+        }
+        return first;
+    }
+
+    std::errc BigIntegerParser::finish(BigInteger &value) {
+        if (!sawDigit) {
+            reset();
+            return std::errc::invalid_argument;
+        }
+
+        BIGNUM_RECORD_OPERATION(Parse, chunks.size());
+        std::reverse(chunks.begin(), chunks.end());
+        // the chunks and the pending digits fit in one limb more than there are chunks; short numbers are
+        // converted on the stack, so a result that fits in the inline limbs does not allocate
+        constexpr size_t SHORT_CHUNKS = kernels::FROM_DECIMAL_THRESHOLD / kernels::DECIMAL_BASE_DIGITS;
+        kernels::limb_t buffer[SHORT_CHUNKS + 1];
+        bool isShort = chunks.size() < SHORT_CHUNKS;
+        if (!isShort) {
+            value.limbs.clear();
+            value.limbs.resize(chunks.size() + 1);
+        }
+        kernels::limb_t *magnitude = isShort ? buffer : value.limbs.data();
+        size_t size = kernels::fromDecimalChunks(chunks.data(), chunks.size(), magnitude);
+        uint64_t scale = 1;
+        for (size_t i = 0; i < pendingDigits; i++)
+            scale *= 10;
+        kernels::limb_t carry = kernels::mul1(magnitude, magnitude, size, scale);
+        carry += kernels::add1(magnitude, magnitude, size, pending);
+        if (carry)
+            magnitude[size++] = carry;
+
+        if (isShort)
+            value.limbs.assign(buffer, buffer + size);
+        else
+            value.limbs.resize(size);
+        value.sign = negative && size ? -1 : 1;
+        reset();
+        return std::errc();
+    }
+
+    void BigIntegerParser::reset() noexcept {
+        state = State::Start;
+        negative = false;
+        sawDigit = false;
+        pending = 0;
+        pendingDigits = 0;
+        chunks.clear();
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+#include "BigInteger.h"
+#include "LimbStorage.h"
+
+namespace BigNum {
+    // parses one decimal number arriving in pieces, e.g. from a socket or a stream: leading whitespace
+    // is skipped, a '-' may precede the digits and the number ends at the first other character.
+    // Digits are packed into limbs as they arrive and converted once the number is finished
+    class BigIntegerParser {
+    public:
+        BigIntegerParser();
+
+        // consumes the characters of [first, last) that belong to the number and returns the first one
+        // that does not; once that is before last the number has ended and done() is set
+        const char *feed(const char *first, const char *last);
+
+        const char *feed(std::string_view chunk) { return feed(chunk.data(), chunk.data() + chunk.size()); }
+
+        // whether a character after the number has been seen, so further input would be ignored
+        bool done() const noexcept { return state == State::Done; }
+
+        // the number parsed so far, or std::errc::invalid_argument if no digit was seen; either way the
+        // parser is reset for the next number
+        std::errc finish(BigInteger &value);
+
+        void reset() noexcept;
+
+    private:
+        enum class State {
+            Start, Sign, Digits, Done
+        };
+
+        State state = State::Start;
+        bool negative = false;
+        bool sawDigit = false;
+        // the digits after the last complete chunk
+        uint64_t pending = 0;
+        size_t pendingDigits = 0;
+        // complete chunks of DECIMAL_BASE_DIGITS digits, most significant first; two chunks are kept
+        // inline, enough for any number that fits in two limbs
+        LimbStorage chunks;
+    };
+}
@@ -0,0 +1,226 @@
+#include <stdexcept>
+#include <utility>
+#include "BigRational.h"
+
+namespace BigNum {
+    namespace {
+        size_t limbCount(const BigInteger &value) {
+            return (value.bitLength() + 63) / 64;
+        }
+
+        BigInteger powerOfTen(size_t n) {
+            BigInteger res(1), base(10);
+            for (; n; n >>= 1) {
+                if (n & 1)
+                    res *= base;
+                if (n > 1)
+                    base *= base;
+            }
+            return res;
+        }
+    }
+
+    BigRational::BigRational() : num(0), den(1), normalized(true), normalizedLimbs(1) {}
+
+    BigRational::BigRational(const BigInteger &value) : num(value), den(1), normalized(true), normalizedLimbs(1) {}
+
+    BigRational::BigRational(int64_t value) : BigRational(BigInteger(value)) {}
+
+    BigRational::BigRational(BigInteger numerator, BigInteger denominator)
+            : BigRational(std::move(numerator), std::move(denominator), false) {
+        if (den == 0)
+            throw std::invalid_argument("Division by zero");
+        if (den < 0) {
+            num = -num;
+            den = -den;
+        }
+    }
+
+    BigRational::BigRational(BigInteger numerator, BigInteger denominator, bool normalized)
+            : num(std::move(numerator)), den(std::move(denominator)), normalized(normalized), normalizedLimbs(1) {}
+
+    const BigInteger &BigRational::numerator() const {
+        normalize();
+        return num;
+    }
+
+    const BigInteger &BigRational::denominator() const {
+        normalize();
+        return den;
+    }
+
+    void BigRational::normalize() const {
+        if (!normalized) {
+            BigInteger g = gcd(num, den);
+            if (g != 1) {
+                num /= g;
+                den /= g;
+            }
+            normalized = true;
+        }
+        normalizedLimbs = limbCount(den);
+    }
+
+    void BigRational::maybeNormalize() {
+        if (!normalized && limbCount(den) >= normalizedLimbs + NORMALIZE_LIMBS)
+            normalize();
+    }
+
+    BigRational BigRational::operator+(const BigRational &oth) const {
+        BigRational res = *this;
+        res += oth;
+        return res;
+    }
+
+    BigRational BigRational::operator-(const BigRational &oth) const {
+        BigRational res = *this;
+        res -= oth;
+        return res;
+    }
+
+    BigRational BigRational::operator*(const BigRational &oth) const {
+        BigRational res = *this;
+        res *= oth;
+        return res;
+    }
+
+    BigRational BigRational::operator/(const BigRational &oth) const {
+        BigRational res = *this;
+        res /= oth;
+        return res;
+    }
+
+    BigRational BigRational::operator-() const {
+        BigRational res = *this;
+        res.num = -res.num;
+        return res;
+    }
+
+    BigRational &BigRational::operator+=(const BigRational &oth) {
+        if (den == oth.den) {
+            // a common denominator may now share a factor with the sum
+            num += oth.num;
+            normalized = den == 1;
+        } else if (oth.den == 1) {
+            // no new factors: gcd(a + c b, b) = gcd(a, b)
+            num += oth.num * den;
+        } else {
+            num = num * oth.den + oth.num * den;
+            den *= oth.den;
+            normalized = false;
+        }
+        maybeNormalize();
+        return *this;
+    }
+
+    BigRational &BigRational::operator-=(const BigRational &oth) {
+        return *this += -oth;
+    }
+
+    BigRational &BigRational::operator*=(const BigRational &oth) {
+        num *= oth.num;
+        if (oth.den != 1) {
+            den *= oth.den;
+            normalized = false;
+        } else {
+            // the new numerator factors may cancel against the denominator
+            normalized = den == 1;
+        }
+        maybeNormalize();
+        return *this;
+    }
+
+    BigRational &BigRational::operator/=(const BigRational &oth) {
+        if (oth.num == 0)
+            throw std::invalid_argument("Division by zero");
+        // oth may be *this
+        BigInteger othNum = oth.num, othDen = oth.den;
+        num *= othDen;
+        den *= othNum;
+        if (den < 0) {
+            num = -num;
+            den = -den;
+        }
+        normalized = den == 1;
+        maybeNormalize();
+        return *this;
+    }
+
+    int BigRational::sign() const {
+        return num > 0 ? 1 : num < 0 ? -1 : 0;
+    }
+
+    int BigRational::compareTo(const BigRational &oth) const {
+        int s = sign(), othSign = oth.sign();
+        if (s != othSign)
+            return s < othSign ? -1 : 1;
+        if (s == 0)
+            return 0;
+        if (den == oth.den)
+            return num < oth.num ? -1 : num > oth.num ? 1 : 0;
+
+        // |a d| and |c b| have bit lengths within one of the sums of the parts' bit lengths
+        size_t left = num.bitLength() + oth.den.bitLength();
+        size_t right = oth.num.bitLength() + den.bitLength();
+        if (left > right + 1)
+            return s;
+        if (right > left + 1)
+            return -s;
+
+        BigInteger a = num * oth.den, c = oth.num * den;
+        return a < c ? -1 : a > c ? 1 : 0;
+    }
+
+    bool BigRational::operator==(const BigRational &oth) const {
+        if (den == oth.den || (normalized && oth.normalized))
+            return num == oth.num && den == oth.den;
+        return compareTo(oth) == 0;
+    }
+
+    bool BigRational::operator!=(const BigRational &oth) const {
+        return !(*this == oth);
+    }
+
+    bool BigRational::operator<(const BigRational &oth) const {
+        return compareTo(oth) < 0;
+    }
+
+    bool BigRational::operator>(const BigRational &oth) const {
+        return compareTo(oth) > 0;
+    }
+
+    bool BigRational::operator<=(const BigRational &oth) const {
+        return compareTo(oth) <= 0;
+    }
+
+    bool BigRational::operator>=(const BigRational &oth) const {
+        return compareTo(oth) >= 0;
+    }
+
+    double BigRational::toDouble() const {
+        return num.realDivide(den);
+    }
+
+    std::string BigRational::toString() const {
+        normalize();
+        if (den == 1)
+            return num.toString();
+        return num.toString() + "/" + den.toString();
+    }
+
+    std::string BigRational::toDecimalString(size_t fractionDigits) const {
+        auto qr = (num.abs() * powerOfTen(fractionDigits)).divmod(den);
+        BigInteger digits = std::move(qr.first);
+        if (qr.second * 2 >= den)
+            digits += 1;
+
+        std::string str = digits.toString();
+        if (str.size() <= fractionDigits)
+            str.insert(0, fractionDigits + 1 - str.size(), '0');
+        if (fractionDigits)
+            str.insert(str.size() - fractionDigits, 1, '.');
+        if (num < 0 && digits != 0)
+            str.insert(0, 1, '-');
+        return str;
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "BigInteger.h"
+
+namespace BigNum {
+    // exact fraction of two BigIntegers. Arithmetic does not reduce its result by the gcd; that
+    // happens when the parts or a string are asked for, or once the denominator has grown by
+    // NORMALIZE_LIMBS since it was last reduced. The denominator is always positive.
+    // Reducing modifies the parts of a const value, so a value shared between threads must not be read
+    // concurrently through the normalizing accessors
+    class BigRational {
+    public:
+        static constexpr size_t NORMALIZE_LIMBS = 16;
+
+        BigRational();
+
+        BigRational(const BigInteger &value);
+
+        BigRational(int64_t value);
+
+        // throws std::invalid_argument for a zero denominator
+        BigRational(BigInteger numerator, BigInteger denominator);
+
+        // parts in lowest terms
+        const BigInteger &numerator() const;
+
+        const BigInteger &denominator() const;
+
+        bool isNormalized() const noexcept { return normalized; }
+
+        // reduces to lowest terms now
+        void normalize() const;
+
+        BigRational operator+(const BigRational &oth) const;
+
+        BigRational operator-(const BigRational &oth) const;
+
+        BigRational operator*(const BigRational &oth) const;
+
+        // throws std::invalid_argument when oth is zero
+        BigRational operator/(const BigRational &oth) const;
+
+        BigRational operator-() const;
+
+        BigRational &operator+=(const BigRational &oth);
+
+        BigRational &operator-=(const BigRational &oth);
+
+        BigRational &operator*=(const BigRational &oth);
+
+        BigRational &operator/=(const BigRational &oth);
+
+        bool operator==(const BigRational &oth) const;
+
+        bool operator!=(const BigRational &oth) const;
+
+        bool operator<(const BigRational &oth) const;
+
+        bool operator>(const BigRational &oth) const;
+
+        bool operator<=(const BigRational &oth) const;
+
+        bool operator>=(const BigRational &oth) const;
+
+        // -1, 0 or 1
+        int sign() const;
+
+        // nearest double, computed from the unreduced parts
+        double toDouble() const;
+
+        // "p/q" in lowest terms, or "p" for an integer
+        std::string toString() const;
+
+        // decimal with exactly fractionDigits digits after the point, rounded half away from zero
+        std::string toDecimalString(size_t fractionDigits) const;
+
+    private:
+        mutable BigInteger num;
+        mutable BigInteger den;
+        mutable bool normalized;
+        // limbs of the denominator when it was last reduced
+        mutable size_t normalizedLimbs;
+
+        BigRational(BigInteger numerator, BigInteger denominator, bool normalized);
+
+        // reduces once the denominator has outgrown the threshold
+        void maybeNormalize();
+
+        int compareTo(const BigRational &oth) const;
+    };
+}
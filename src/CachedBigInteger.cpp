@@ -0,0 +1,73 @@
+#include <algorithm>
+#include "CachedBigInteger.h"
+
+namespace BigNum {
+    CachedBigInteger &CachedBigInteger::operator=(BigInteger value) {
+        invalidate();
+        val = std::move(value);
+        return *this;
+    }
+
+    CachedBigInteger &CachedBigInteger::operator+=(const BigInteger &oth) {
+        invalidate();
+        val += oth;
+        return *this;
+    }
+
+    CachedBigInteger &CachedBigInteger::operator-=(const BigInteger &oth) {
+        invalidate();
+        val -= oth;
+        return *this;
+    }
+
+    CachedBigInteger &CachedBigInteger::operator*=(const BigInteger &oth) {
+        invalidate();
+        val *= oth;
+        return *this;
+    }
+
+    CachedBigInteger &CachedBigInteger::operator+=(int64_t oth) {
+        invalidate();
+        val += oth;
+        return *this;
+    }
+
+    CachedBigInteger &CachedBigInteger::operator-=(int64_t oth) {
+        invalidate();
+        val -= oth;
+        return *this;
+    }
+
+    CachedBigInteger &CachedBigInteger::operator*=(int64_t oth) {
+        invalidate();
+        val *= oth;
+        return *this;
+    }
+
+    const std::string &CachedBigInteger::toString() const {
+        if (!cached) {
+            // renders into the buffer of the previous form
+            text.resize(val.decimalLength());
+            char *end = to_chars(&text[0], &text[0] + text.size(), val).ptr;
+            text.resize(static_cast<size_t>(end - text.data()));
+            cached = true;
+        }
+        return text;
+    }
+
+    size_t CachedBigInteger::decimalLength() const noexcept {
+        return cached ? text.size() : val.decimalLength();
+    }
+
+    void CachedBigInteger::invalidate() noexcept {
+        text.clear();
+        cached = false;
+    }
+
+    std::to_chars_result to_chars(char *first, char *last, const CachedBigInteger &value) {
+        const std::string &str = value.toString();
+        if (str.size() > static_cast<size_t>(last - first))
+            return {last, std::errc::value_too_large};
+        return {std::copy(str.begin(), str.end(), first), std::errc()};
+    }
+}
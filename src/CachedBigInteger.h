@@ -0,0 +1,66 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include "BigInteger.h"
+
+namespace BigNum {
+    // BigInteger that keeps its decimal form once rendered, so printing an unchanged value again only
+    // copies the cached string. The value is read through value() and changed only through the
+    // assignments and modify(), each of which drops the cached form.
+    // Rendering fills the cache of a const object, so a value shared between threads must not be
+    // printed concurrently
+    class CachedBigInteger {
+    public:
+        CachedBigInteger() = default;
+
+        CachedBigInteger(BigInteger value) : val(std::move(value)) {}
+
+        CachedBigInteger &operator=(BigInteger value);
+
+        const BigInteger &value() const noexcept { return val; }
+
+        operator const BigInteger &() const noexcept { return val; }
+
+        // calls f with a mutable reference to the value and returns its result
+        template<typename F>
+        decltype(auto) modify(F &&f) {
+            invalidate();
+            return std::forward<F>(f)(val);
+        }
+
+        CachedBigInteger &operator+=(const BigInteger &oth);
+
+        CachedBigInteger &operator-=(const BigInteger &oth);
+
+        CachedBigInteger &operator*=(const BigInteger &oth);
+
+        CachedBigInteger &operator+=(int64_t oth);
+
+        CachedBigInteger &operator-=(int64_t oth);
+
+        CachedBigInteger &operator*=(int64_t oth);
+
+        // renders the value on the first call after a change
+        const std::string &toString() const;
+
+        // exact once the value has been rendered, the BigInteger bound otherwise
+        size_t decimalLength() const noexcept;
+
+        bool isCached() const noexcept { return cached; }
+
+        void invalidate() noexcept;
+
+        friend std::to_chars_result to_chars(char *first, char *last, const CachedBigInteger &value);
+
+    private:
+        BigInteger val;
+        mutable std::string text;
+        mutable bool cached = false;
+    };
+
+    std::to_chars_result to_chars(char *first, char *last, const CachedBigInteger &value);
+}
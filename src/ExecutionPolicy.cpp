@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ExecutionPolicy.h"
+
+namespace BigNum {
+    namespace {
+        std::atomic<unsigned> defaultThreads{1};
+        std::atomic<size_t> defaultMinLimbs{ExecutionPolicy::DEFAULT_MIN_LIMBS};
+
+        thread_local const ExecutionPolicy *threadPolicy = nullptr;
+        // set on pool workers and on a thread while it runs a parallelFor, whose nested calls stay sequential
+        thread_local bool insideParallel = false;
+
+        // persistent workers that join the calling thread on one parallelFor job at a time; a job claims
+        // indices from a shared counter, so threads that finish early keep taking work from the others
+        class ThreadPool {
+        public:
+            ~ThreadPool() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                wake.notify_all();
+                for (auto &worker : workers)
+                    worker.join();
+            }
+
+            void run(size_t count, const std::function<void(size_t)> &f, unsigned threads) {
+                // a second caller does not wait for the pool, it works alone instead
+                std::unique_lock<std::mutex> busy(jobMutex, std::try_to_lock);
+                if (!busy) {
+                    for (size_t i = 0; i < count; i++)
+                        f(i);
+                    return;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    while (workers.size() + 1 < threads)
+                        workers.emplace_back([this] { work(); });
+                    job = &f;
+                    jobCount = count;
+                    next = 0;
+                    error = nullptr;
+                    seats = std::min<size_t>(threads - 1, count - 1);
+                }
+                wake.notify_all();
+
+                drain(f, count);
+
+                std::unique_lock<std::mutex> lock(mutex);
+                job = nullptr;
+                seats = 0;
+                done.wait(lock, [this] { return running == 0; });
+                if (error)
+                    std::rethrow_exception(error);
+            }
+
+        private:
+            std::mutex jobMutex;
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::condition_variable done;
+            std::vector<std::thread> workers;
+            const std::function<void(size_t)> *job = nullptr;
+            size_t jobCount = 0;
+            size_t seats = 0;
+            size_t running = 0;
+            std::atomic<size_t> next{0};
+            std::exception_ptr error;
+            bool stopping = false;
+
+            void drain(const std::function<void(size_t)> &f, size_t count) {
+                for (size_t i; (i = next.fetch_add(1)) < count;) {
+                    try {
+                        f(i);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!error)
+                            error = std::current_exception();
+                        next = count;
+                    }
+                }
+            }
+
+            void work() {
+                insideParallel = true;
+                std::unique_lock<std::mutex> lock(mutex);
+                while (true) {
+                    wake.wait(lock, [this] { return stopping || (job && seats > 0); });
+                    if (stopping)
+                        return;
+                    seats--;
+                    running++;
+                    const auto &f = *job;
+                    size_t count = jobCount;
+                    lock.unlock();
+                    drain(f, count);
+                    lock.lock();
+                    if (--running == 0)
+                        done.notify_all();
+                }
+            }
+        };
+
+        ThreadPool &pool() {
+            static ThreadPool instance;
+            return instance;
+        }
+    }
+
+    ExecutionPolicy ExecutionPolicy::sequential() noexcept {
+        return {};
+    }
+
+    ExecutionPolicy ExecutionPolicy::parallel(unsigned threads, size_t minLimbs) noexcept {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        return {threads, minLimbs};
+    }
+
+    ExecutionPolicy currentExecutionPolicy() noexcept {
+        if (threadPolicy)
+            return *threadPolicy;
+        return {defaultThreads.load(std::memory_order_relaxed), defaultMinLimbs.load(std::memory_order_relaxed)};
+    }
+
+    void setDefaultExecutionPolicy(const ExecutionPolicy &policy) noexcept {
+        defaultThreads.store(std::max(1u, policy.threads), std::memory_order_relaxed);
+        defaultMinLimbs.store(policy.minLimbs, std::memory_order_relaxed);
+    }
+
+    ExecutionScope::ExecutionScope(const ExecutionPolicy &policy) noexcept: previous(threadPolicy), policy(policy) {
+        threadPolicy = &this->policy;
+    }
+
+    ExecutionScope::~ExecutionScope() {
+        threadPolicy = previous;
+    }
+
+    namespace kernels {
+        bool runParallel(size_t n) noexcept {
+            if (insideParallel)
+                return false;
+            ExecutionPolicy policy = currentExecutionPolicy();
+            return policy.threads > 1 && n >= policy.minLimbs;
+        }
+
+        void parallelFor(size_t count, const std::function<void(size_t)> &f) {
+            unsigned threads = insideParallel ? 1 : currentExecutionPolicy().threads;
+            if (threads <= 1 || count <= 1) {
+                for (size_t i = 0; i < count; i++)
+                    f(i);
+                return;
+            }
+
+            insideParallel = true;
+            try {
+                pool().run(count, f, threads);
+            } catch (...) {
+                insideParallel = false;
+                throw;
+            }
+            insideParallel = false;
+        }
+
+        void parallelRanges(size_t n, bool parallel, const std::function<void(size_t, size_t)> &f) {
+            unsigned threads = parallel ? currentExecutionPolicy().threads : 1;
+            // a few ranges per thread even out threads that get descheduled
+            size_t ranges = std::min<size_t>(n, 4 * size_t(threads));
+            if (threads <= 1 || ranges <= 1) {
+                f(0, n);
+                return;
+            }
+            parallelFor(ranges, [&](size_t i) {
+                f(n * i / ranges, n * (i + 1) / ranges);
+            });
+        }
+    }
+}
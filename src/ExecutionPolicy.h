@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace BigNum {
+    // how far one operation may spread over threads; the default keeps everything on the calling thread
+    struct ExecutionPolicy {
+        static constexpr size_t DEFAULT_MIN_LIMBS = 10000;
+
+        // threads working on one product, the calling thread included
+        unsigned threads = 1;
+        // size (in limbs of the shorter operand) below which products stay sequential
+        size_t minLimbs = DEFAULT_MIN_LIMBS;
+
+        static ExecutionPolicy sequential() noexcept;
+
+        // threads = 0 stands for every hardware thread
+        static ExecutionPolicy parallel(unsigned threads = 0, size_t minLimbs = DEFAULT_MIN_LIMBS) noexcept;
+    };
+
+    // policy of the calling thread: the innermost ExecutionScope, otherwise the global default
+    ExecutionPolicy currentExecutionPolicy() noexcept;
+
+    // changes the policy of every thread that is not inside an ExecutionScope
+    void setDefaultExecutionPolicy(const ExecutionPolicy &policy) noexcept;
+
+    // overrides the policy on this thread while alive; scopes nest like ResourceScope.
+    // Worker threads allocate their temporaries from the default resource, never from the
+    // caller's ResourceScope
+    class ExecutionScope {
+    public:
+        explicit ExecutionScope(const ExecutionPolicy &policy) noexcept;
+
+        ExecutionScope(const ExecutionScope &) = delete;
+
+        ExecutionScope &operator=(const ExecutionScope &) = delete;
+
+        ~ExecutionScope();
+
+    private:
+        const ExecutionPolicy *previous;
+        ExecutionPolicy policy;
+    };
+
+    namespace kernels {
+        // whether an operation on operands of n limbs should spread over threads under the current policy;
+        // always false inside parallelFor
+        bool runParallel(size_t n) noexcept;
+
+        // runs f(0) .. f(count - 1) on the threads of the current policy, returning once all calls are done
+        // and rethrowing the first exception one of them threw
+        void parallelFor(size_t count, const std::function<void(size_t)> &f);
+
+        // runs f(begin, end) on consecutive ranges covering [0, n), on several threads when parallel is set
+        void parallelRanges(size_t n, bool parallel, const std::function<void(size_t, size_t)> &f);
+    }
+}
@@ -0,0 +1,482 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "BigInteger.h"
+
+namespace BigNum {
+    // what the arithmetic of a fixed-width integer does with results outside its range: Wrap reduces them
+    // modulo 2^Bits like the built-in unsigned types, Checked throws BigInteger::OverflowException
+    enum class Overflow {
+        Wrap, Checked
+    };
+
+    // integer of exactly Bits bits (a multiple of 64) kept in two's complement in a std::array, for values
+    // with a known maximum width that should not pay for allocation or variable-length loops. All
+    // arithmetic is constexpr; division truncates like BigInteger and shifts of signed values are
+    // arithmetic
+    template<size_t Bits, bool Signed, Overflow Policy>
+    class BasicFixedInt {
+        static_assert(Bits > 0 && Bits % 64 == 0, "Bits must be a positive multiple of 64");
+
+    public:
+        static constexpr size_t LIMBS = Bits / 64;
+        static constexpr bool IS_SIGNED = Signed;
+
+        using Limbs = std::array<uint64_t, LIMBS>;
+
+        constexpr BasicFixedInt() noexcept: limbs{} {}
+
+        // built-in integers convert implicitly, sign extended for signed types
+        template<typename T, typename = std::enable_if_t<std::is_integral<T>::value && sizeof(T) <= sizeof(uint64_t)>>
+        constexpr BasicFixedInt(T val) : limbs{} {
+            bool negative = std::is_signed<T>::value && val < 0;
+            if (Policy == Overflow::Checked && negative && !Signed)
+                throw BigInteger::OverflowException("Negative value in an unsigned fixed-width integer");
+            if (Policy == Overflow::Checked && Signed && LIMBS == 1 && !std::is_signed<T>::value &&
+                static_cast<uint64_t>(val) >> 63)
+                throw BigInteger::OverflowException("Value out of range of the fixed-width integer");
+            limbs[0] = static_cast<uint64_t>(val);
+            for (size_t i = 1; i < LIMBS; i++)
+                limbs[i] = negative ? ~uint64_t(0) : 0;
+        }
+
+        // reduced modulo 2^Bits, or range checked with Overflow::Checked
+        explicit BasicFixedInt(const BigInteger &val) : limbs{} {
+            const uint64_t *magnitude = val.limbs.data();
+            size_t size = val.limbs.size();
+            bool negative = val.sign < 0;
+            if (Policy == Overflow::Checked) {
+                bool fits = size <= LIMBS && (!negative || Signed);
+                if (fits && Signed && size == LIMBS && magnitude[LIMBS - 1] >> 63) {
+                    // only -2^(Bits - 1) has the top bit set
+                    fits = negative && magnitude[LIMBS - 1] == uint64_t(1) << 63;
+                    for (size_t i = 0; fits && i + 1 < LIMBS; i++)
+                        fits = magnitude[i] == 0;
+                }
+                if (!fits)
+                    throw BigInteger::OverflowException("Value out of range of the fixed-width integer");
+            }
+            std::copy_n(magnitude, std::min(size, LIMBS), limbs.begin());
+            if (negative)
+                negate(limbs);
+        }
+
+        static constexpr BasicFixedInt max() noexcept {
+            BasicFixedInt res;
+            for (auto &limb : res.limbs)
+                limb = ~uint64_t(0);
+            if (Signed)
+                res.limbs[LIMBS - 1] >>= 1;
+            return res;
+        }
+
+        static constexpr BasicFixedInt min() noexcept {
+            BasicFixedInt res;
+            if (Signed)
+                res.limbs[LIMBS - 1] = uint64_t(1) << 63;
+            return res;
+        }
+
+        constexpr const Limbs &data() const noexcept { return limbs; }
+
+        constexpr bool isNegative() const noexcept { return Signed && limbs[LIMBS - 1] >> 63; }
+
+        constexpr bool isZero() const noexcept {
+            uint64_t any = 0;
+            for (uint64_t limb : limbs)
+                any |= limb;
+            return any == 0;
+        }
+
+        BigInteger toBigInteger() const {
+            Limbs magnitude = limbs;
+            BigInteger res;
+            if (isNegative()) {
+                negate(magnitude);
+                res.sign = -1;
+            }
+            res.limbs.assign(magnitude.data(), magnitude.data() + LIMBS);
+            res.trimZeros();
+            return res;
+        }
+
+        explicit operator BigInteger() const { return toBigInteger(); }
+
+        std::string toString() const { return toBigInteger().toString(); }
+
+        constexpr BasicFixedInt operator-() const {
+            BasicFixedInt res = *this;
+            if (Policy == Overflow::Checked && (Signed ? *this == min() : !isZero()))
+                throw BigInteger::OverflowException("Negation overflows the fixed-width integer");
+            negate(res.limbs);
+            return res;
+        }
+
+        constexpr BasicFixedInt operator~() const noexcept {
+            BasicFixedInt res;
+            for (size_t i = 0; i < LIMBS; i++)
+                res.limbs[i] = ~limbs[i];
+            return res;
+        }
+
+        friend constexpr BasicFixedInt operator+(const BasicFixedInt &a, const BasicFixedInt &b) {
+            BasicFixedInt res;
+            uint64_t carry = addLimbs(res.limbs, a.limbs, b.limbs, std::make_index_sequence<LIMBS>());
+            if (Policy == Overflow::Checked &&
+                (Signed ? a.isNegative() == b.isNegative() && res.isNegative() != a.isNegative() : carry != 0))
+                throw BigInteger::OverflowException("Addition overflows the fixed-width integer");
+            return res;
+        }
+
+        friend constexpr BasicFixedInt operator-(const BasicFixedInt &a, const BasicFixedInt &b) {
+            BasicFixedInt res;
+            uint64_t borrow = subLimbs(res.limbs, a.limbs, b.limbs, std::make_index_sequence<LIMBS>());
+            if (Policy == Overflow::Checked &&
+                (Signed ? a.isNegative() != b.isNegative() && res.isNegative() != a.isNegative() : borrow != 0))
+                throw BigInteger::OverflowException("Subtraction overflows the fixed-width integer");
+            return res;
+        }
+
+        friend constexpr BasicFixedInt operator*(const BasicFixedInt &a, const BasicFixedInt &b) {
+            BasicFixedInt res;
+            if (Policy == Overflow::Wrap) {
+                // the low half of the product is the same for signed and unsigned operands
+                mulLow(res.limbs, a.limbs, b.limbs, std::make_index_sequence<LIMBS>());
+                return res;
+            }
+
+            Limbs x = a.limbs, y = b.limbs;
+            if (a.isNegative())
+                negate(x);
+            if (b.isNegative())
+                negate(y);
+            std::array<uint64_t, 2 * LIMBS> product{};
+            mulFull(product, x, y, std::make_index_sequence<LIMBS>());
+            uint64_t high = 0;
+            for (size_t i = LIMBS; i < 2 * LIMBS; i++)
+                high |= product[i];
+            for (size_t i = 0; i < LIMBS; i++)
+                res.limbs[i] = product[i];
+            bool negative = a.isNegative() != b.isNegative();
+            // a signed magnitude may reach 2^(Bits - 1) only for a negative result, which is min()
+            bool fits = high == 0 && (!Signed || !(res.limbs[LIMBS - 1] >> 63) || (negative && res == min()));
+            if (!fits)
+                throw BigInteger::OverflowException("Multiplication overflows the fixed-width integer");
+            if (negative)
+                negate(res.limbs);
+            return res;
+        }
+
+        friend constexpr BasicFixedInt operator/(const BasicFixedInt &a, const BasicFixedInt &b) {
+            return divmod(a, b).first;
+        }
+
+        friend constexpr BasicFixedInt operator%(const BasicFixedInt &a, const BasicFixedInt &b) {
+            return divmod(a, b).second;
+        }
+
+        friend constexpr BasicFixedInt operator&(const BasicFixedInt &a, const BasicFixedInt &b) noexcept {
+            BasicFixedInt res;
+            for (size_t i = 0; i < LIMBS; i++)
+                res.limbs[i] = a.limbs[i] & b.limbs[i];
+            return res;
+        }
+
+        friend constexpr BasicFixedInt operator|(const BasicFixedInt &a, const BasicFixedInt &b) noexcept {
+            BasicFixedInt res;
+            for (size_t i = 0; i < LIMBS; i++)
+                res.limbs[i] = a.limbs[i] | b.limbs[i];
+            return res;
+        }
+
+        friend constexpr BasicFixedInt operator^(const BasicFixedInt &a, const BasicFixedInt &b) noexcept {
+            BasicFixedInt res;
+            for (size_t i = 0; i < LIMBS; i++)
+                res.limbs[i] = a.limbs[i] ^ b.limbs[i];
+            return res;
+        }
+
+        // bits shifted out are lost, and with Overflow::Checked a changed value throws
+        constexpr BasicFixedInt operator<<(size_t shift) const {
+            BasicFixedInt res = shiftedLeft(shift);
+            if (Policy == Overflow::Checked && res.shiftedRight(shift) != *this)
+                throw BigInteger::OverflowException("Shift overflows the fixed-width integer");
+            return res;
+        }
+
+        constexpr BasicFixedInt operator>>(size_t shift) const noexcept { return shiftedRight(shift); }
+
+        friend constexpr bool operator==(const BasicFixedInt &a, const BasicFixedInt &b) noexcept {
+            uint64_t diff = 0;
+            for (size_t i = 0; i < LIMBS; i++)
+                diff |= a.limbs[i] ^ b.limbs[i];
+            return diff == 0;
+        }
+
+        friend constexpr bool operator!=(const BasicFixedInt &a, const BasicFixedInt &b) noexcept {
+            return !(a == b);
+        }
+
+        friend constexpr bool operator<(const BasicFixedInt &a, const BasicFixedInt &b) noexcept {
+            return compare(a, b) < 0;
+        }
+
+        friend constexpr bool operator>(const BasicFixedInt &a, const BasicFixedInt &b) noexcept {
+            return compare(a, b) > 0;
+        }
+
+        friend constexpr bool operator<=(const BasicFixedInt &a, const BasicFixedInt &b) noexcept {
+            return compare(a, b) <= 0;
+        }
+
+        friend constexpr bool operator>=(const BasicFixedInt &a, const BasicFixedInt &b) noexcept {
+            return compare(a, b) >= 0;
+        }
+
+        constexpr BasicFixedInt &operator+=(const BasicFixedInt &oth) { return *this = *this + oth; }
+
+        constexpr BasicFixedInt &operator-=(const BasicFixedInt &oth) { return *this = *this - oth; }
+
+        constexpr BasicFixedInt &operator*=(const BasicFixedInt &oth) { return *this = *this * oth; }
+
+        constexpr BasicFixedInt &operator/=(const BasicFixedInt &oth) { return *this = *this / oth; }
+
+        constexpr BasicFixedInt &operator%=(const BasicFixedInt &oth) { return *this = *this % oth; }
+
+        constexpr BasicFixedInt &operator&=(const BasicFixedInt &oth) noexcept { return *this = *this & oth; }
+
+        constexpr BasicFixedInt &operator|=(const BasicFixedInt &oth) noexcept { return *this = *this | oth; }
+
+        constexpr BasicFixedInt &operator^=(const BasicFixedInt &oth) noexcept { return *this = *this ^ oth; }
+
+        constexpr BasicFixedInt &operator<<=(size_t shift) { return *this = *this << shift; }
+
+        constexpr BasicFixedInt &operator>>=(size_t shift) noexcept { return *this = *this >> shift; }
+
+        // quotient rounded towards zero and the remainder with the sign of the dividend
+        friend constexpr std::pair<BasicFixedInt, BasicFixedInt> divmod(const BasicFixedInt &a, const BasicFixedInt &b) {
+            if (b.isZero())
+                throw std::invalid_argument("Division by zero");
+            if (Policy == Overflow::Checked && Signed && a == min() && b == BasicFixedInt(-1))
+                throw BigInteger::OverflowException("Division overflows the fixed-width integer");
+
+            Limbs x = a.limbs, y = b.limbs;
+            if (a.isNegative())
+                negate(x);
+            if (b.isNegative())
+                negate(y);
+            std::pair<BasicFixedInt, BasicFixedInt> res;
+            divideMagnitudes(res.first.limbs, res.second.limbs, x, y);
+            if (a.isNegative() != b.isNegative())
+                negate(res.first.limbs);
+            if (a.isNegative())
+                negate(res.second.limbs);
+            return res;
+        }
+
+    private:
+        Limbs limbs;
+
+        static constexpr uint64_t addCarry(uint64_t a, uint64_t b, uint64_t &carry) noexcept {
+            uint64_t s = a + carry;
+            uint64_t out = s < carry;
+            uint64_t r = s + b;
+            carry = out + (r < s);
+            return r;
+        }
+
+        static constexpr uint64_t subBorrow(uint64_t a, uint64_t b, uint64_t &borrow) noexcept {
+            uint64_t d = a - b;
+            uint64_t out = a < b;
+            uint64_t r = d - borrow;
+            borrow = out + (d < borrow);
+            return r;
+        }
+
+        // the carry chains are expanded over the index sequence, so there is no loop left to run
+        template<size_t... I>
+        static constexpr uint64_t addLimbs(Limbs &r, const Limbs &a, const Limbs &b, std::index_sequence<I...>) noexcept {
+            uint64_t carry = 0;
+            ((r[I] = addCarry(a[I], b[I], carry)), ...);
+            return carry;
+        }
+
+        template<size_t... I>
+        static constexpr uint64_t subLimbs(Limbs &r, const Limbs &a, const Limbs &b, std::index_sequence<I...>) noexcept {
+            uint64_t borrow = 0;
+            ((r[I] = subBorrow(a[I], b[I], borrow)), ...);
+            return borrow;
+        }
+
+        static constexpr uint64_t mulAdd(uint64_t a, uint64_t b, uint64_t acc, uint64_t &carry) noexcept {
+            unsigned __int128 t = (unsigned __int128) a * b + acc + carry;
+            carry = static_cast<uint64_t>(t >> 64);
+            return static_cast<uint64_t>(t);
+        }
+
+        // r[Row + J] += x * y[J] for every J, returning the carry out of the last limb
+        template<size_t Row, typename R, size_t... J>
+        static constexpr uint64_t mulAddRow(R &r, uint64_t x, const Limbs &y, std::index_sequence<J...>) noexcept {
+            uint64_t carry = 0;
+            ((r[Row + J] = mulAdd(x, y[J], r[Row + J], carry)), ...);
+            return carry;
+        }
+
+        // schoolbook rows expanded like the carry chains, keeping only the limbs below LIMBS
+        template<size_t... I>
+        static constexpr void mulLow(Limbs &r, const Limbs &a, const Limbs &b, std::index_sequence<I...>) noexcept {
+            (mulAddRow<I>(r, a[I], b, std::make_index_sequence<LIMBS - I>()), ...);
+        }
+
+        template<size_t... I>
+        static constexpr void mulFull(std::array<uint64_t, 2 * LIMBS> &r, const Limbs &a, const Limbs &b,
+                                      std::index_sequence<I...>) noexcept {
+            ((r[I + LIMBS] = mulAddRow<I>(r, a[I], b, std::make_index_sequence<LIMBS>())), ...);
+        }
+
+        // -1, 0 or 1 from the most significant differing limb
+        template<size_t... I>
+        static constexpr int compareLimbs(const Limbs &a, const Limbs &b, std::index_sequence<I...>) noexcept {
+            int res = 0;
+            ((res = res ? res : (a[LIMBS - 1 - I] > b[LIMBS - 1 - I]) - (a[LIMBS - 1 - I] < b[LIMBS - 1 - I])), ...);
+            return res;
+        }
+
+        static constexpr int compare(const BasicFixedInt &a, const BasicFixedInt &b) noexcept {
+            if (a.isNegative() != b.isNegative())
+                return a.isNegative() ? -1 : 1;
+            // equal signs compare like their two's complement bits
+            return compareLimbs(a.limbs, b.limbs, std::make_index_sequence<LIMBS>());
+        }
+
+        static constexpr void negate(Limbs &a) noexcept {
+            uint64_t carry = 1;
+            for (auto &limb : a) {
+                limb = ~limb + carry;
+                carry = carry && limb == 0;
+            }
+        }
+
+        constexpr BasicFixedInt shiftedLeft(size_t shift) const noexcept {
+            BasicFixedInt res;
+            if (shift >= Bits)
+                return res;
+            size_t words = shift / 64;
+            unsigned bits = shift % 64;
+            for (size_t i = LIMBS; i-- > words;) {
+                uint64_t low = bits && i > words ? limbs[i - words - 1] >> (64 - bits) : 0;
+                res.limbs[i] = (limbs[i - words] << bits) | low;
+            }
+            return res;
+        }
+
+        constexpr BasicFixedInt shiftedRight(size_t shift) const noexcept {
+            uint64_t fill = isNegative() ? ~uint64_t(0) : 0;
+            BasicFixedInt res;
+            if (shift >= Bits) {
+                for (auto &limb : res.limbs)
+                    limb = fill;
+                return res;
+            }
+            size_t words = shift / 64;
+            unsigned bits = shift % 64;
+            for (size_t i = 0; i < LIMBS; i++) {
+                uint64_t cur = i + words < LIMBS ? limbs[i + words] : fill;
+                uint64_t next = i + words + 1 < LIMBS ? limbs[i + words + 1] : fill;
+                res.limbs[i] = bits ? (cur >> bits) | (next << (64 - bits)) : cur;
+            }
+            return res;
+        }
+
+        static constexpr size_t significantLimbs(const Limbs &a) noexcept {
+            size_t n = LIMBS;
+            while (n > 0 && a[n - 1] == 0)
+                n--;
+            return n;
+        }
+
+        static constexpr unsigned leadingZeros(uint64_t x) noexcept {
+            unsigned n = 0;
+            for (uint64_t bit = uint64_t(1) << 63; bit && !(x & bit); bit >>= 1)
+                n++;
+            return n;
+        }
+
+        // q = x / y and r = x % y of magnitudes by Knuth's algorithm D
+        static constexpr void divideMagnitudes(Limbs &q, Limbs &r, const Limbs &x, const Limbs &y) {
+            size_t m = significantLimbs(x);
+            size_t n = significantLimbs(y);
+            if (m < n) {
+                r = x;
+                return;
+            }
+            if (n == 1) {
+                uint64_t rem = 0;
+                for (size_t i = m; i-- > 0;) {
+                    unsigned __int128 cur = ((unsigned __int128) rem << 64) | x[i];
+                    q[i] = static_cast<uint64_t>(cur / y[0]);
+                    rem = static_cast<uint64_t>(cur % y[0]);
+                }
+                r[0] = rem;
+                return;
+            }
+
+            // normalize so that the top limb of the divisor has its top bit set
+            unsigned shift = leadingZeros(y[n - 1]);
+            Limbs v{};
+            std::array<uint64_t, LIMBS + 1> u{};
+            for (size_t i = n; i-- > 0;)
+                v[i] = (y[i] << shift) | (shift && i ? y[i - 1] >> (64 - shift) : 0);
+            u[m] = shift ? x[m - 1] >> (64 - shift) : 0;
+            for (size_t i = m; i-- > 0;)
+                u[i] = (x[i] << shift) | (shift && i ? x[i - 1] >> (64 - shift) : 0);
+
+            for (size_t j = m - n + 1; j-- > 0;) {
+                unsigned __int128 top = ((unsigned __int128) u[j + n] << 64) | u[j + n - 1];
+                unsigned __int128 qhat = top / v[n - 1];
+                unsigned __int128 rhat = top % v[n - 1];
+                while (qhat >> 64 || qhat * v[n - 2] > ((rhat << 64) | u[j + n - 2])) {
+                    qhat--;
+                    rhat += v[n - 1];
+                    if (rhat >> 64)
+                        break;
+                }
+
+                // u[j..j+n] -= qhat * v
+                uint64_t carry = 0, borrow = 0;
+                for (size_t i = 0; i < n; i++) {
+                    unsigned __int128 p = qhat * v[i] + carry;
+                    carry = static_cast<uint64_t>(p >> 64);
+                    u[i + j] = subBorrow(u[i + j], static_cast<uint64_t>(p), borrow);
+                }
+                u[j + n] = subBorrow(u[j + n], carry, borrow);
+
+                if (borrow) {
+                    // qhat was one too large, add v back
+                    qhat--;
+                    carry = 0;
+                    for (size_t i = 0; i < n; i++)
+                        u[i + j] = addCarry(u[i + j], v[i], carry);
+                    u[j + n] += carry;
+                }
+                q[j] = static_cast<uint64_t>(qhat);
+            }
+
+            for (size_t i = 0; i < n; i++)
+                r[i] = (u[i] >> shift) | (shift ? u[i + 1] << (64 - shift) : 0);
+        }
+    };
+
+    template<size_t Bits, Overflow Policy = Overflow::Wrap>
+    using FixedInt = BasicFixedInt<Bits, true, Policy>;
+
+    template<size_t Bits, Overflow Policy = Overflow::Wrap>
+    using FixedUInt = BasicFixedInt<Bits, false, Policy>;
+}
@@ -0,0 +1,85 @@
+#include <chrono>
+#include "Instrumentation.h"
+
+namespace BigNum {
+    namespace {
+        thread_local InstrumentationStats threadStats;
+        // outermost operation running on this thread, nullptr outside of operations
+        thread_local OperationStats *activeOperation = nullptr;
+
+        uint64_t now() noexcept {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+    }
+
+    const char *operationName(Operation op) noexcept {
+        static const char *const names[OPERATION_COUNT] = {
+                "parse", "toString", "compare", "add", "subtract", "multiply", "divide", "modulo", "divmod",
+                "bitwise", "shift", "root", "powMod", "gcd"};
+        return names[static_cast<size_t>(op)];
+    }
+
+    const char *algorithmName(Algorithm algorithm) noexcept {
+        static const char *const names[ALGORITHM_COUNT] = {
+                "mulBasecase", "mulKaratsuba", "mulToom3", "mulNtt", "divLimb", "divSchoolbook",
+                "divBurnikelZiegler", "powMontgomery", "powBarrett", "gcdLehmer", "gcdHalfGcd"};
+        return names[static_cast<size_t>(algorithm)];
+    }
+
+    void Histogram::add(uint64_t value) noexcept {
+        counts[value ? 64 - __builtin_clzll(value) : 0]++;
+    }
+
+    uint64_t Histogram::total() const noexcept {
+        uint64_t res = 0;
+        for (uint64_t count : counts)
+            res += count;
+        return res;
+    }
+
+    InstrumentationStats instrumentationSnapshot() {
+        return threadStats;
+    }
+
+    void resetInstrumentation() noexcept {
+        threadStats = InstrumentationStats();
+    }
+
+    namespace instrumentation {
+        OperationScope::OperationScope(Operation op, size_t limbs) noexcept: stats(nullptr), start(0) {
+            if (activeOperation)
+                return;
+            stats = &threadStats.operations[static_cast<size_t>(op)];
+            stats->calls++;
+            stats->limbs.add(limbs);
+            activeOperation = stats;
+            start = now();
+        }
+
+        OperationScope::~OperationScope() {
+            if (!stats)
+                return;
+            stats->nanoseconds.add(now() - start);
+            activeOperation = nullptr;
+        }
+
+        void recordAlgorithm(Algorithm algorithm) noexcept {
+            threadStats.algorithms[static_cast<size_t>(algorithm)]++;
+        }
+
+        void recordAllocation(size_t bytes) noexcept {
+            threadStats.allocations++;
+            threadStats.allocatedBytes += bytes;
+            if (activeOperation) {
+                activeOperation->allocations++;
+                activeOperation->allocatedBytes += bytes;
+            }
+        }
+
+        void recordDeallocation(size_t bytes) noexcept {
+            threadStats.deallocations++;
+            threadStats.freedBytes += bytes;
+        }
+    }
+}
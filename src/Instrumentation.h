@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// set by the BIGNUM_INSTRUMENTATION CMake option; without it the recording macros below compile to nothing
+#ifndef BIGNUM_INSTRUMENTATION
+#define BIGNUM_INSTRUMENTATION 0
+#endif
+
+namespace BigNum {
+    // public operations whose calls are recorded; an operation running inside another one, like the
+    // addition inside operator+(int64_t) or the division inside operator%, belongs to the outer one
+    enum class Operation {
+        Parse, ToString, Compare, Add, Subtract, Multiply, Divide, Modulo, DivMod, Bitwise, Shift, Root,
+        PowMod, Gcd, Count
+    };
+
+    // algorithms picked by the size dispatch of the kernels; recursive dispatches are counted too
+    enum class Algorithm {
+        MulBasecase, MulKaratsuba, MulToom3, MulNtt, DivLimb, DivSchoolbook, DivBurnikelZiegler,
+        PowMontgomery, PowBarrett, GcdLehmer, GcdHalfGcd, Count
+    };
+
+    constexpr size_t OPERATION_COUNT = static_cast<size_t>(Operation::Count);
+    constexpr size_t ALGORITHM_COUNT = static_cast<size_t>(Algorithm::Count);
+
+    constexpr bool INSTRUMENTATION_ENABLED = BIGNUM_INSTRUMENTATION;
+
+    const char *operationName(Operation op) noexcept;
+
+    const char *algorithmName(Algorithm algorithm) noexcept;
+
+    // counts of values in power-of-two buckets: bucket 0 holds 0 and bucket i the values in [2^(i-1), 2^i)
+    struct Histogram {
+        static constexpr size_t BUCKETS = 65;
+
+        std::array<uint64_t, BUCKETS> counts{};
+
+        void add(uint64_t value) noexcept;
+
+        uint64_t total() const noexcept;
+    };
+
+    struct OperationStats {
+        uint64_t calls = 0;
+        // heap buffers that LimbStorage allocated while the operation ran
+        uint64_t allocations = 0;
+        uint64_t allocatedBytes = 0;
+        // limbs of the larger operand
+        Histogram limbs;
+        Histogram nanoseconds;
+    };
+
+    struct InstrumentationStats {
+        std::array<OperationStats, OPERATION_COUNT> operations{};
+        std::array<uint64_t, ALGORITHM_COUNT> algorithms{};
+        // every LimbStorage heap buffer of the thread, whether inside an operation or not
+        uint64_t allocations = 0;
+        uint64_t deallocations = 0;
+        uint64_t allocatedBytes = 0;
+        uint64_t freedBytes = 0;
+
+        const OperationStats &operator[](Operation op) const noexcept {
+            return operations[static_cast<size_t>(op)];
+        }
+
+        uint64_t operator[](Algorithm algorithm) const noexcept {
+            return algorithms[static_cast<size_t>(algorithm)];
+        }
+    };
+
+    // copy of the counters of the calling thread, all zero unless built with BIGNUM_INSTRUMENTATION
+    InstrumentationStats instrumentationSnapshot();
+
+    // zeroes the counters of the calling thread
+    void resetInstrumentation() noexcept;
+
+    namespace instrumentation {
+        // records a call of op with its latency and allocations, unless another operation is already running
+        class OperationScope {
+        public:
+            OperationScope(Operation op, size_t limbs) noexcept;
+
+            OperationScope(const OperationScope &) = delete;
+
+            OperationScope &operator=(const OperationScope &) = delete;
+
+            ~OperationScope();
+
+        private:
+            OperationStats *stats;
+            uint64_t start;
+        };
+
+        void recordAlgorithm(Algorithm algorithm) noexcept;
+
+        void recordAllocation(size_t bytes) noexcept;
+
+        void recordDeallocation(size_t bytes) noexcept;
+    }
+}
+
+#if BIGNUM_INSTRUMENTATION
+#define BIGNUM_RECORD_OPERATION(op, limbs) \
+    ::BigNum::instrumentation::OperationScope bignumOperationScope(::BigNum::Operation::op, limbs)
+#define BIGNUM_RECORD_ALGORITHM(algorithm) \
+    ::BigNum::instrumentation::recordAlgorithm(::BigNum::Algorithm::algorithm)
+#define BIGNUM_RECORD_ALLOCATION(bytes) ::BigNum::instrumentation::recordAllocation(bytes)
+#define BIGNUM_RECORD_DEALLOCATION(bytes) ::BigNum::instrumentation::recordDeallocation(bytes)
+#else
+#define BIGNUM_RECORD_OPERATION(op, limbs) ((void) 0)
+#define BIGNUM_RECORD_ALGORITHM(algorithm) ((void) 0)
+#define BIGNUM_RECORD_ALLOCATION(bytes) ((void) 0)
+#define BIGNUM_RECORD_DEALLOCATION(bytes) ((void) 0)
+#endif
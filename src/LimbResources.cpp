@@ -0,0 +1,26 @@
+#include "LimbResources.h"
+
+namespace BigNum {
+    namespace {
+        thread_local std::pmr::memory_resource *threadResource = nullptr;
+    }
+
+    std::pmr::memory_resource *currentResource() noexcept {
+        return threadResource ? threadResource : std::pmr::get_default_resource();
+    }
+
+    ResourceScope::ResourceScope(std::pmr::memory_resource *resource) noexcept: previous(threadResource) {
+        threadResource = resource;
+    }
+
+    ResourceScope::~ResourceScope() {
+        threadResource = previous;
+    }
+
+    LimbArena::LimbArena(size_t initialLimbs, std::pmr::memory_resource *upstream)
+            : monotonic_buffer_resource(initialLimbs * sizeof(uint64_t), upstream) {}
+
+    LimbPool::LimbPool(std::pmr::memory_resource *upstream)
+            : unsynchronized_pool_resource({MAX_BLOCKS_PER_CHUNK, LARGEST_POOLED_LIMBS * sizeof(uint64_t)},
+                                           upstream) {}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace BigNum {
+    // resource used for new limb buffers on this thread, std::pmr::get_default_resource() unless
+    // changed by a ResourceScope
+    std::pmr::memory_resource *currentResource() noexcept;
+
+    // makes every limb buffer first allocated on this thread while the scope is alive come from
+    // the given resource; scopes nest and restore the previous resource when destroyed.
+    // Values allocated inside the scope must not outlive the resource, copy them out with
+    // BigInteger(value, resource) first
+    class ResourceScope {
+    public:
+        explicit ResourceScope(std::pmr::memory_resource *resource) noexcept;
+
+        ResourceScope(const ResourceScope &) = delete;
+
+        ResourceScope &operator=(const ResourceScope &) = delete;
+
+        ~ResourceScope();
+
+    private:
+        std::pmr::memory_resource *previous;
+    };
+
+    // monotonic arena for the temporaries of one request, everything is freed at once by release()
+    // or destruction
+    class LimbArena : public std::pmr::monotonic_buffer_resource {
+    public:
+        static constexpr size_t DEFAULT_INITIAL_LIMBS = 4096;
+
+        explicit LimbArena(size_t initialLimbs = DEFAULT_INITIAL_LIMBS,
+                           std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+    };
+
+    // single-threaded pool with size classes from 1 to LARGEST_POOLED_LIMBS limbs, larger buffers
+    // go straight to the upstream resource; meant to be used as one pool per worker thread
+    class LimbPool : public std::pmr::unsynchronized_pool_resource {
+    public:
+        static constexpr size_t LARGEST_POOLED_LIMBS = 1024;
+        static constexpr size_t MAX_BLOCKS_PER_CHUNK = 256;
+
+        explicit LimbPool(std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+    };
+}
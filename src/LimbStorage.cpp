@@ -0,0 +1,118 @@
+#include <algorithm>
+#include "Instrumentation.h"
+#include "LimbStorage.h"
+
+namespace BigNum {
+
+    LimbStorage::LimbStorage(const LimbStorage &oth) {
+        assign(oth.begin(), oth.end());
+    }
+
+    LimbStorage::LimbStorage(const LimbStorage &oth, std::pmr::memory_resource *resource) {
+        if (oth.count > cap)
+            grow(oth.count, resource);
+        std::copy(oth.begin(), oth.end(), data());
+        count = oth.count;
+    }
+
+    LimbStorage::LimbStorage(LimbStorage &&oth) noexcept {
+        *this = std::move(oth);
+    }
+
+    LimbStorage LimbStorage::borrow(const uint64_t *limbs, size_t n) noexcept {
+        LimbStorage res;
+        if (n == 0)
+            return res;
+        // never written while borrowed, unshare() copies first
+        res.heap = {const_cast<uint64_t *>(limbs), nullptr};
+        res.cap = 0;
+        res.count = n;
+        return res;
+    }
+
+    LimbStorage &LimbStorage::operator=(const LimbStorage &oth) {
+        if (this != &oth)
+            assign(oth.begin(), oth.end());
+        return *this;
+    }
+
+    LimbStorage &LimbStorage::operator=(LimbStorage &&oth) noexcept {
+        if (this == &oth)
+            return *this;
+        if (oth.isInline()) {
+            // nothing to steal, copying keeps our own buffer for later reuse
+            if (isBorrowed())
+                release();
+            std::copy(oth.local, oth.local + oth.count, data());
+        } else {
+            release();
+            heap = oth.heap;
+            cap = oth.cap;
+            oth.cap = INLINE_CAPACITY;
+        }
+        count = oth.count;
+        oth.count = 0;
+        return *this;
+    }
+
+    LimbStorage::~LimbStorage() {
+        release();
+    }
+
+    void LimbStorage::resize(size_t n) {
+        reserve(n);
+        if (n > count)
+            std::fill(data() + count, data() + n, 0);
+        count = n;
+    }
+
+    void LimbStorage::assign(size_t n, uint64_t value) {
+        clear();
+        reserve(n);
+        std::fill(data(), data() + n, value);
+        count = n;
+    }
+
+    void LimbStorage::assign(const uint64_t *first, const uint64_t *last) {
+        size_t n = last - first;
+        clear();
+        reserve(n);
+        std::copy(first, last, data());
+        count = n;
+    }
+
+    bool LimbStorage::operator==(const LimbStorage &oth) const noexcept {
+        return count == oth.count && std::equal(begin(), end(), oth.begin());
+    }
+
+    void LimbStorage::grow(size_t minCapacity, std::pmr::memory_resource *resource) {
+        size_t newCapacity = std::max(minCapacity, 2 * cap);
+        auto *buffer = static_cast<uint64_t *>(resource->allocate(newCapacity * sizeof(uint64_t),
+                                                                   alignof(uint64_t)));
+        BIGNUM_RECORD_ALLOCATION(newCapacity * sizeof(uint64_t));
+        std::copy(data(), data() + count, buffer);
+        release();
+        heap.limbs = buffer;
+        heap.resource = resource;
+        cap = newCapacity;
+    }
+
+    void LimbStorage::release() noexcept {
+        if (!isInline() && !isBorrowed()) {
+            heap.resource->deallocate(heap.limbs, cap * sizeof(uint64_t), alignof(uint64_t));
+            BIGNUM_RECORD_DEALLOCATION(cap * sizeof(uint64_t));
+        }
+        cap = INLINE_CAPACITY;
+    }
+
+    void LimbStorage::unshare() {
+        const uint64_t *borrowed = heap.limbs;
+        size_t n = count;
+        cap = INLINE_CAPACITY;
+        count = 0;
+        if (n > INLINE_CAPACITY)
+            grow(n, currentResource());
+        std::copy(borrowed, borrowed + n, data());
+        count = n;
+    }
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include "LimbResources.h"
+
+namespace BigNum {
+    // vector-like limb buffer that keeps up to INLINE_CAPACITY limbs inside the object and only
+    // allocates once a value grows past that; a heap buffer comes from the thread's current resource
+    // when the value first spills and later growth stays in the same resource.
+    // A borrowed storage views limbs owned elsewhere and copies them on the first non-const access
+    class LimbStorage {
+    public:
+        static constexpr size_t INLINE_CAPACITY = 2;
+
+        using iterator = uint64_t *;
+        using const_iterator = const uint64_t *;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        LimbStorage() noexcept = default;
+
+        LimbStorage(const LimbStorage &oth);
+
+        // copy whose heap buffer, if any, comes from the given resource
+        LimbStorage(const LimbStorage &oth, std::pmr::memory_resource *resource);
+
+        LimbStorage(LimbStorage &&oth) noexcept;
+
+        // read-only view of n limbs owned by the caller, which must outlive every use of the view
+        static LimbStorage borrow(const uint64_t *limbs, size_t n) noexcept;
+
+        LimbStorage &operator=(const LimbStorage &oth);
+
+        LimbStorage &operator=(LimbStorage &&oth) noexcept;
+
+        ~LimbStorage();
+
+        size_t size() const noexcept { return count; }
+
+        size_t capacity() const noexcept { return cap; }
+
+        bool empty() const noexcept { return count == 0; }
+
+        bool isInline() const noexcept { return cap == INLINE_CAPACITY; }
+
+        // a borrowed storage has no capacity of its own
+        bool isBorrowed() const noexcept { return cap == 0; }
+
+        uint64_t *data() {
+            if (isBorrowed())
+                unshare();
+            return isInline() ? local : heap.limbs;
+        }
+
+        const uint64_t *data() const noexcept { return isInline() ? local : heap.limbs; }
+
+        // resource owning the heap buffer, nullptr while the limbs are inline or borrowed
+        std::pmr::memory_resource *resource() const noexcept { return isInline() ? nullptr : heap.resource; }
+
+        uint64_t &operator[](size_t i) { return data()[i]; }
+
+        uint64_t operator[](size_t i) const noexcept { return data()[i]; }
+
+        uint64_t &back() { return data()[count - 1]; }
+
+        uint64_t back() const noexcept { return data()[count - 1]; }
+
+        iterator begin() { return data(); }
+
+        iterator end() { return data() + count; }
+
+        const_iterator begin() const noexcept { return data(); }
+
+        const_iterator end() const noexcept { return data() + count; }
+
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        void push_back(uint64_t limb) {
+            if (count >= cap)
+                reserve(count + 1);
+            data()[count++] = limb;
+        }
+
+        void pop_back() noexcept { count--; }
+
+        void clear() noexcept { count = 0; }
+
+        void reserve(size_t n) {
+            if (isBorrowed())
+                unshare();
+            if (n > cap)
+                grow(n, isInline() ? currentResource() : heap.resource);
+        }
+
+        // new limbs are zero
+        void resize(size_t n);
+
+        void assign(size_t n, uint64_t value);
+
+        void assign(const uint64_t *first, const uint64_t *last);
+
+        template<typename It>
+        void assign(It first, It last) {
+            clear();
+            reserve(static_cast<size_t>(std::distance(first, last)));
+            for (; first != last; ++first)
+                data()[count++] = *first;
+        }
+
+        bool operator==(const LimbStorage &oth) const noexcept;
+
+        bool operator!=(const LimbStorage &oth) const noexcept { return !(*this == oth); }
+
+    private:
+        size_t count = 0;
+        size_t cap = INLINE_CAPACITY;
+        struct Heap {
+            uint64_t *limbs;
+            std::pmr::memory_resource *resource;
+        };
+        union {
+            uint64_t local[INLINE_CAPACITY] = {};
+            Heap heap;
+        };
+
+        // moves to a heap buffer of at least minCapacity limbs from the given resource, keeping the contents
+        void grow(size_t minCapacity, std::pmr::memory_resource *resource);
+
+        void release() noexcept;
+
+        // replaces borrowed limbs by a copy of its own
+        void unshare();
+    };
+}
@@ -0,0 +1,163 @@
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include "MappedBigIntegerArray.h"
+
+namespace BigNum {
+    namespace {
+        constexpr char MAGIC[8] = {'B', 'I', 'G', 'N', 'U', 'M', 'A', '1'};
+        // magic and count
+        constexpr size_t HEADER_WORDS = 2;
+
+        void writeWord(std::ostream &out, uint64_t word) {
+            unsigned char bytes[sizeof(uint64_t)];
+            for (size_t i = 0; i < sizeof(uint64_t); i++)
+                bytes[i] = static_cast<unsigned char>(word >> (8 * i));
+            out.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+        }
+
+        [[noreturn]] void malformed(const std::string &path) {
+            throw std::runtime_error("Malformed BigInteger array: " + path);
+        }
+
+        // closes the descriptor once the file is mapped or on failure
+        class FileDescriptor {
+        public:
+            explicit FileDescriptor(int fd) noexcept: fd(fd) {}
+
+            FileDescriptor(const FileDescriptor &) = delete;
+
+            FileDescriptor &operator=(const FileDescriptor &) = delete;
+
+            ~FileDescriptor() {
+                if (fd >= 0)
+                    close(fd);
+            }
+
+            int fd;
+        };
+    }
+
+    MappedBigIntegerArray::MappedBigIntegerArray(const std::string &path) {
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+        // the limbs are only usable in place where they are in native order
+        throw std::runtime_error("Mapped BigInteger arrays need a little-endian target");
+#endif
+        FileDescriptor file(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (file.fd < 0)
+            throw std::system_error(errno, std::generic_category(), path);
+        struct stat info{};
+        if (fstat(file.fd, &info) != 0)
+            throw std::system_error(errno, std::generic_category(), path);
+        auto size = static_cast<size_t>(info.st_size);
+        if (size < (HEADER_WORDS + 1) * sizeof(uint64_t) || size % sizeof(uint64_t) != 0)
+            malformed(path);
+
+        void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+        if (mapping == MAP_FAILED)
+            throw std::system_error(errno, std::generic_category(), path);
+        words = static_cast<const uint64_t *>(mapping);
+        bytes = size;
+
+        // every element is checked once here so that operator[] can hand out views unchecked
+        size_t total = size / sizeof(uint64_t);
+        uint64_t n = words[1];
+        if (std::memcmp(words, MAGIC, sizeof(MAGIC)) != 0 || n > total - HEADER_WORDS - 1) {
+            unmap();
+            malformed(path);
+        }
+        count = static_cast<size_t>(n);
+        const uint64_t *offsets = words + HEADER_WORDS;
+        bool valid = offsets[0] == HEADER_WORDS + count + 1 && offsets[count] == total;
+        for (size_t i = 0; valid && i < count; i++) {
+            uint64_t start = offsets[i], end = offsets[i + 1];
+            if (end <= start || end > total) {
+                valid = false;
+                break;
+            }
+            uint64_t header = words[start];
+            uint64_t limbs = header >> 1;
+            valid = limbs == end - start - 1 && (limbs > 0 ? words[end - 1] != 0 : header == 0);
+        }
+        if (!valid) {
+            unmap();
+            malformed(path);
+        }
+    }
+
+    MappedBigIntegerArray::MappedBigIntegerArray(MappedBigIntegerArray &&oth) noexcept
+            : words(oth.words), bytes(oth.bytes), count(oth.count) {
+        oth.words = nullptr;
+        oth.bytes = 0;
+        oth.count = 0;
+    }
+
+    MappedBigIntegerArray &MappedBigIntegerArray::operator=(MappedBigIntegerArray &&oth) noexcept {
+        if (this != &oth) {
+            unmap();
+            std::swap(words, oth.words);
+            std::swap(bytes, oth.bytes);
+            std::swap(count, oth.count);
+        }
+        return *this;
+    }
+
+    MappedBigIntegerArray::~MappedBigIntegerArray() {
+        unmap();
+    }
+
+    void MappedBigIntegerArray::unmap() noexcept {
+        if (words)
+            munmap(const_cast<uint64_t *>(words), bytes);
+        words = nullptr;
+        bytes = 0;
+        count = 0;
+    }
+
+    BigInteger MappedBigIntegerArray::operator[](size_t i) const {
+        const uint64_t *element = words + words[HEADER_WORDS + i];
+        BigInteger res;
+        res.sign = *element & 1 ? -1 : 1;
+        res.limbs = LimbStorage::borrow(element + 1, static_cast<size_t>(*element >> 1));
+        return res;
+    }
+
+    BigInteger MappedBigIntegerArray::at(size_t i) const {
+        if (i >= count)
+            throw std::out_of_range("BigInteger array index out of range");
+        return (*this)[i];
+    }
+
+    void MappedBigIntegerArray::write(std::ostream &out, const std::vector<BigInteger> &values) {
+        out.write(MAGIC, sizeof(MAGIC));
+        writeWord(out, values.size());
+        uint64_t offset = HEADER_WORDS + values.size() + 1;
+        writeWord(out, offset);
+        for (const auto &value : values) {
+            offset += 1 + value.limbs.size();
+            writeWord(out, offset);
+        }
+        for (const auto &value : values) {
+            writeWord(out, value.limbs.size() * 2 + (value.sign < 0));
+            for (uint64_t limb : value.limbs)
+                writeWord(out, limb);
+        }
+    }
+
+    void MappedBigIntegerArray::write(const std::string &path, const std::vector<BigInteger> &values) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::system_error(errno, std::generic_category(), path);
+        write(out, values);
+        out.close();
+        if (!out)
+            throw std::system_error(errno, std::generic_category(), path);
+    }
+}
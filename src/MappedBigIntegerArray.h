@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "BigInteger.h"
+
+namespace BigNum {
+    // read-only memory-mapped file of BigIntegers. Unlike the compact format of BigInteger::serialize,
+    // limbs are stored 8-byte aligned so that elements can share the mapping instead of being parsed:
+    // the magic "BIGNUMA1", the element count, count + 1 word offsets from the file start, then for
+    // each element a word 2 * limbCount + (negative ? 1 : 0) followed by its limbs, all little-endian
+    class MappedBigIntegerArray {
+    public:
+        // maps and validates the file, throwing std::system_error if it cannot be mapped and
+        // std::runtime_error if it is not a well-formed array
+        explicit MappedBigIntegerArray(const std::string &path);
+
+        MappedBigIntegerArray(const MappedBigIntegerArray &) = delete;
+
+        MappedBigIntegerArray &operator=(const MappedBigIntegerArray &) = delete;
+
+        MappedBigIntegerArray(MappedBigIntegerArray &&oth) noexcept;
+
+        MappedBigIntegerArray &operator=(MappedBigIntegerArray &&oth) noexcept;
+
+        ~MappedBigIntegerArray();
+
+        size_t size() const noexcept { return count; }
+
+        bool empty() const noexcept { return count == 0; }
+
+        // element i as a view of the mapped limbs, valid while the array stays mapped; modifying the
+        // view copies its limbs first and copying it gives an independent value
+        BigInteger operator[](size_t i) const;
+
+        // operator[] throwing std::out_of_range for i >= size()
+        BigInteger at(size_t i) const;
+
+        static void write(std::ostream &out, const std::vector<BigInteger> &values);
+
+        static void write(const std::string &path, const std::vector<BigInteger> &values);
+
+    private:
+        const uint64_t *words = nullptr;
+        size_t bytes = 0;
+        size_t count = 0;
+
+        void unmap() noexcept;
+    };
+}
@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include "conversion.h"
+#include "divide.h"
+#include "multiply.h"
+
+namespace BigNum {
+    namespace kernels {
+        namespace {
+            // the digits of a[0..n) for n < TO_DECIMAL_THRESHOLD, zero padded to width unless that is 0.
+            // Without padding this is the leading piece of the number: its digits and the trailing digits
+            // of the pieces after it must end by last, or nothing is written and nullptr is returned
+            char *toDecimalBasecase(const limb_t *a, size_t n, char *out, size_t width, const char *last,
+                                    size_t trailing) {
+                // a limb takes a little more than one chunk, so both buffers fit on the stack
+                limb_t rest[TO_DECIMAL_THRESHOLD];
+                limb_t chunks[TO_DECIMAL_THRESHOLD + 2];
+                size_t count = 0;
+                std::copy(a, a + n, rest);
+                while (n > 0) {
+                    chunks[count++] = divRem1(rest, rest, n, DECIMAL_BASE);
+                    n = normalizedSize(rest, n);
+                }
+
+                char buffer[DECIMAL_BASE_DIGITS];
+                size_t digits = count * DECIMAL_BASE_DIGITS;
+                size_t skip = 0;
+                if (width == 0) {
+                    // no leading zeros in the top chunk
+                    for (limb_t top = count ? chunks[count - 1] : 0; top; top /= 10)
+                        skip++;
+                    skip = count ? DECIMAL_BASE_DIGITS - skip : 0;
+                    if (static_cast<size_t>(last - out) < digits - skip + trailing)
+                        return nullptr;
+                } else {
+                    out = std::fill_n(out, width - digits, '0');
+                }
+                for (size_t c = count; c-- > 0;) {
+                    limb_t chunk = chunks[c];
+                    for (size_t i = DECIMAL_BASE_DIGITS; i-- > 0;) {
+                        buffer[i] = static_cast<char>('0' + chunk % 10);
+                        chunk /= 10;
+                    }
+                    out = std::copy(buffer + skip, buffer + DECIMAL_BASE_DIGITS, out);
+                    skip = 0;
+                }
+                return out;
+            }
+
+            size_t fromDecimalBasecase(const char *digits, size_t len, limb_t *out) {
+                size_t n = 0;
+                // consume the digits in limb-sized chunks, the first one taking the remainder
+                size_t chunkSize = len % DECIMAL_BASE_DIGITS;
+                if (chunkSize == 0)
+                    chunkSize = DECIMAL_BASE_DIGITS;
+                for (size_t pos = 0; pos < len; pos += chunkSize, chunkSize = DECIMAL_BASE_DIGITS) {
+                    limb_t chunk = 0;
+                    limb_t scale = 1;
+                    for (size_t i = pos; i < pos + chunkSize; i++) {
+                        chunk = chunk * 10 + (digits[i] - '0'); // ascii value to actual number
+                        scale *= 10;
+                    }
+                    limb_t carry = mul1(out, out, n, scale);
+                    carry += add1(out, out, n, chunk);
+                    if (carry)
+                        out[n++] = carry;
+                }
+                return normalizedSize(out, n);
+            }
+
+            size_t fromDecimalChunksBasecase(const limb_t *chunks, size_t n, limb_t *out) {
+                size_t size = 0;
+                for (size_t i = n; i-- > 0;) {
+                    limb_t carry = mul1(out, out, size, DECIMAL_BASE);
+                    carry += add1(out, out, size, chunks[i]);
+                    if (carry)
+                        out[size++] = carry;
+                }
+                return normalizedSize(out, size);
+            }
+
+            // high * power + low
+            Scratch joinDecimal(const Scratch &high, const std::vector<limb_t> &power, const Scratch &low) {
+                auto res = makeScratch(std::max(high.size() + power.size(), low.size()) + 1);
+                if (!high.empty()) {
+                    if (high.size() >= power.size())
+                        mul(res.data(), high.data(), high.size(), power.data(), power.size());
+                    else
+                        mul(res.data(), power.data(), power.size(), high.data(), high.size());
+                }
+                if (!low.empty())
+                    add(res.data(), res.data(), res.size(), low.data(), low.size());
+                res.resize(normalizedSize(res.data(), res.size()));
+                return res;
+            }
+
+            // splits at the largest cached power of ten about half the size of a; padding and the fit check
+            // work as in toDecimalBasecase
+            char *toDecimalSplit(const limb_t *a, size_t n, char *out, size_t width, const char *last,
+                                 size_t trailing) {
+                n = normalizedSize(a, n);
+                if (n < TO_DECIMAL_THRESHOLD)
+                    return toDecimalBasecase(a, n, out, width, last, trailing);
+
+                size_t k = 0;
+                while (decimalPower(k + 1).size() * 2 <= n + 1)
+                    k++;
+                const auto &power = decimalPower(k);
+                size_t lowDigits = DECIMAL_BASE_DIGITS << k;
+
+                auto q = makeScratch(n - power.size() + 1);
+                auto r = makeScratch(power.size());
+                divRem(q.data(), r.data(), a, n, power.data(), power.size());
+                out = toDecimalSplit(q.data(), q.size(), out, width ? width - lowDigits : 0, last,
+                                     trailing + lowDigits);
+                if (!out)
+                    return nullptr;
+                return toDecimalSplit(r.data(), r.size(), out, lowDigits, last, trailing);
+            }
+        }
+
+        const std::vector<limb_t> &decimalPower(size_t k) {
+            // a deque keeps references to earlier entries valid while the table grows; the table is
+            // shared, so it stays on the global heap rather than the thread's resource. Finished entries
+            // never change and are published through published[], so only growing the table locks
+            static std::deque<std::vector<limb_t>> powers;
+            static std::array<std::atomic<const std::vector<limb_t> *>, 64> published;
+            static std::mutex mutex;
+
+            if (const auto *power = published[k].load(std::memory_order_acquire))
+                return *power;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (powers.empty()) {
+                powers.push_back({DECIMAL_BASE});
+                published[0].store(&powers.back(), std::memory_order_release);
+            }
+            while (powers.size() <= k) {
+                const auto &last = powers.back();
+                std::vector<limb_t> square(2 * last.size());
+                mul(square.data(), last.data(), last.size(), last.data(), last.size());
+                square.resize(normalizedSize(square.data(), square.size()));
+                powers.push_back(std::move(square));
+                published[powers.size() - 1].store(&powers.back(), std::memory_order_release);
+            }
+            return powers[k];
+        }
+
+        size_t decimalDigitsBound(const limb_t *a, size_t n) noexcept {
+            n = normalizedSize(a, n);
+            if (n == 0)
+                return 1;
+            // a < 2^bits has at most floor(bits * log10(2)) + 1 digits; the constant is log10(2) * 2^32
+            // rounded up, so the product never falls below the true digit count
+            uint64_t bits = 64 * (n - 1) + 64 - __builtin_clzll(a[n - 1]);
+            return static_cast<size_t>((static_cast<unsigned __int128>(bits) * 1292913987u) >> 32) + 1;
+        }
+
+        char *toDecimal(const limb_t *a, size_t n, char *first, char *last) {
+            return toDecimalSplit(a, n, first, 0, last, 0);
+        }
+
+        // the low 19 * 2^k digits and the rest are parsed independently and joined with one multiplication
+        Scratch fromDecimal(const char *digits, size_t len) {
+            if (len < FROM_DECIMAL_THRESHOLD) {
+                auto res = makeScratch(decimalLimbsBound(len));
+                res.resize(fromDecimalBasecase(digits, len, res.data()));
+                return res;
+            }
+
+            size_t k = 0;
+            while ((DECIMAL_BASE_DIGITS << (k + 1)) * 2 <= len)
+                k++;
+            size_t lowDigits = DECIMAL_BASE_DIGITS << k;
+            const auto &power = decimalPower(k);
+
+            auto high = fromDecimal(digits, len - lowDigits);
+            auto low = fromDecimal(digits + len - lowDigits, lowDigits);
+            return joinDecimal(high, power, low);
+        }
+
+        // same split as fromDecimal, with the low 2^k chunks standing for 19 * 2^k digits
+        Scratch fromDecimalChunks(const limb_t *chunks, size_t n) {
+            if (n * DECIMAL_BASE_DIGITS < FROM_DECIMAL_THRESHOLD) {
+                auto res = makeScratch(n);
+                res.resize(fromDecimalChunksBasecase(chunks, n, res.data()));
+                return res;
+            }
+
+            size_t k = 0;
+            while ((size_t(1) << (k + 1)) * 2 <= n)
+                k++;
+            size_t lowChunks = size_t(1) << k;
+            const auto &power = decimalPower(k);
+
+            auto high = fromDecimalChunks(chunks + lowChunks, n - lowChunks);
+            auto low = fromDecimalChunks(chunks, lowChunks);
+            return joinDecimal(high, power, low);
+        }
+
+        size_t fromDecimal(const char *digits, size_t len, limb_t *out) {
+            if (len < FROM_DECIMAL_THRESHOLD)
+                return fromDecimalBasecase(digits, len, out);
+            auto res = fromDecimal(digits, len);
+            std::copy(res.begin(), res.end(), out);
+            return res.size();
+        }
+
+        size_t fromDecimalChunks(const limb_t *chunks, size_t n, limb_t *out) {
+            if (n * DECIMAL_BASE_DIGITS < FROM_DECIMAL_THRESHOLD)
+                return fromDecimalChunksBasecase(chunks, n, out);
+            auto res = fromDecimalChunks(chunks, n);
+            std::copy(res.begin(), res.end(), out);
+            return res.size();
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "kernels.h"
+
+namespace BigNum {
+    namespace kernels {
+        // largest power of 10 that fits in a limb
+        constexpr limb_t DECIMAL_BASE = 10000000000000000000ull;
+        constexpr size_t DECIMAL_BASE_DIGITS = 19;
+
+        // operand sizes below which conversion runs the quadratic chunk-by-chunk loop
+        constexpr size_t TO_DECIMAL_THRESHOLD = 30;
+        constexpr size_t FROM_DECIMAL_THRESHOLD = 600;
+
+        // upper bound on the decimal digits of the magnitude a[0..n), at most one above the exact count
+        size_t decimalDigitsBound(const limb_t *a, size_t n) noexcept;
+
+        // writes the decimal digits of the magnitude a[0..n) to [first, last) and returns the end of the
+        // output, or nullptr without writing anything when they do not fit; a zero magnitude has no digits.
+        // Magnitudes below TO_DECIMAL_THRESHOLD limbs need no scratch memory
+        char *toDecimal(const limb_t *a, size_t n, char *first, char *last);
+
+        // limbs that the magnitude of len decimal digits may take
+        constexpr size_t decimalLimbsBound(size_t len) { return len / DECIMAL_BASE_DIGITS + 1; }
+
+        // magnitude of the decimal digits[0..len), which must all be in '0'..'9'; the result is normalized
+        Scratch fromDecimal(const char *digits, size_t len);
+
+        // the same written to out, which must have room for decimalLimbsBound(len) limbs, returning the
+        // normalized size; inputs below FROM_DECIMAL_THRESHOLD digits need no scratch memory
+        size_t fromDecimal(const char *digits, size_t len, limb_t *out);
+
+        // magnitude of sum(chunks[i] * DECIMAL_BASE^i) for n chunks below DECIMAL_BASE; the result is normalized
+        Scratch fromDecimalChunks(const limb_t *chunks, size_t n);
+
+        // the same written to out, which must have room for n limbs, returning the normalized size
+        size_t fromDecimalChunks(const limb_t *chunks, size_t n, limb_t *out);
+
+        // 10^(19 * 2^k) from a table shared by all threads, computed on first use
+        const std::vector<limb_t> &decimalPower(size_t k);
+    }
+}
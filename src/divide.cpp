@@ -0,0 +1,163 @@
+#include <algorithm>
+#include "Instrumentation.h"
+#include "divide.h"
+#include "multiply.h"
+
+namespace BigNum {
+    namespace kernels {
+        namespace {
+            void divThreeHalvesByTwo(limb_t *q, limb_t *r, const limb_t *a, const limb_t *b, size_t half);
+
+            // q[0..n) and r[0..n) from a[0..2n) / b[0..n) where b has its top bit set and a < b * B^n
+            void divTwoByOne(limb_t *q, limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+                if (n % 2 || n < BURNIKEL_ZIEGLER_THRESHOLD) {
+                    auto quotient = makeScratch(n + 1);
+                    divRemSchoolbook(quotient.data(), r, a, 2 * n, b, n);
+                    std::copy(quotient.begin(), quotient.begin() + n, q);
+                    return;
+                }
+                size_t half = n / 2;
+                // the upper three quarters give the high half of the quotient, the remainder
+                // joined with the last quarter gives the low half
+                auto partial = makeScratch(3 * half);
+                divThreeHalvesByTwo(q + half, partial.data() + half, a + half, b, half);
+                std::copy(a, a + half, partial.begin());
+                divThreeHalvesByTwo(q, r, partial.data(), b, half);
+            }
+
+            // q[0..half) and r[0..2 half) from a[0..3 half) / b[0..2 half) where a < b * B^half
+            void divThreeHalvesByTwo(limb_t *q, limb_t *r, const limb_t *a, const limb_t *b, size_t half) {
+                const limb_t *a1 = a + 2 * half;
+                const limb_t *b1 = b + half;
+
+                // rhat = (a1 a2 - q * b1) * B^half + a3, estimated from the top limbs of the divisor
+                auto rhat = makeScratch(2 * half + 1);
+                if (compare(a1, b1, half) < 0) {
+                    divTwoByOne(q, rhat.data() + half, a + half, b1, half);
+                } else {
+                    // a1 == b1, so q = B^half - 1 and a1 a2 - q * b1 = a2 + b1
+                    std::fill(q, q + half, ~limb_t(0));
+                    rhat[2 * half] = addN(rhat.data() + half, a + half, b1, half);
+                }
+                std::copy(a, a + half, rhat.begin());
+
+                auto d = makeScratch(2 * half);
+                mul(d.data(), q, half, b, half);
+                while (compare(rhat.data(), normalizedSize(rhat.data(), 2 * half + 1),
+                               d.data(), normalizedSize(d.data(), 2 * half)) < 0) {
+                    sub1(q, q, half, 1);
+                    rhat[2 * half] += addN(rhat.data(), rhat.data(), b, 2 * half);
+                }
+                sub(rhat.data(), rhat.data(), 2 * half + 1, d.data(), 2 * half);
+                std::copy(rhat.begin(), rhat.begin() + 2 * half, r);
+            }
+        }
+
+        void divRem(limb_t *q, limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+            if (bn == 1) {
+                BIGNUM_RECORD_ALGORITHM(DivLimb);
+                r[0] = divRem1(q, a, an, b[0]);
+            } else if (bn < BURNIKEL_ZIEGLER_THRESHOLD || an - bn < BURNIKEL_ZIEGLER_THRESHOLD) {
+                BIGNUM_RECORD_ALGORITHM(DivSchoolbook);
+                divRemSchoolbook(q, r, a, an, b, bn);
+            } else {
+                BIGNUM_RECORD_ALGORITHM(DivBurnikelZiegler);
+                divRemBurnikelZiegler(q, r, a, an, b, bn);
+            }
+        }
+
+        void divRemSchoolbook(limb_t *q, limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+            // normalize so that the top bit of the divisor is set, which keeps every estimate within 2 of the truth
+            unsigned shift = countLeadingZeros(b[bn - 1]);
+            auto v = makeScratch(b, b + bn);
+            auto u = makeScratch(an + 1);
+            if (shift) {
+                lshift(v.data(), b, bn, shift);
+                u[an] = lshift(u.data(), a, an, shift);
+            } else {
+                std::copy(a, a + an, u.begin());
+            }
+
+            limb_t top = v[bn - 1];
+            limb_t next = v[bn - 2];
+            for (size_t j = an - bn + 1; j-- > 0;) {
+                limb_t u2 = u[j + bn], u1 = u[j + bn - 1], u0 = u[j + bn - 2];
+                limb_t qhat, rhat;
+                bool rhatOverflow = false;
+                if (u2 >= top) {
+                    qhat = ~limb_t(0);
+                    rhat = u1 + top;
+                    rhatOverflow = rhat < u1;
+                } else {
+                    dlimb_t num = ((dlimb_t) u2 << LIMB_BITS) | u1;
+                    qhat = (limb_t) (num / top);
+                    rhat = (limb_t) (num % top);
+                }
+                while (!rhatOverflow && (dlimb_t) qhat * next > (((dlimb_t) rhat << LIMB_BITS) | u0)) {
+                    qhat--;
+                    rhat += top;
+                    rhatOverflow = rhat < top;
+                }
+
+                limb_t borrow = subMul1(u.data() + j, v.data(), bn, qhat);
+                if (u2 < borrow) {
+                    // the estimate was one too large, add the divisor back
+                    qhat--;
+                    u[j + bn] = u2 - borrow + addN(u.data() + j, u.data() + j, v.data(), bn);
+                } else {
+                    u[j + bn] = u2 - borrow;
+                }
+                q[j] = qhat;
+            }
+
+            if (shift)
+                rshift(r, u.data(), bn, shift);
+            else
+                std::copy(u.begin(), u.begin() + bn, r);
+        }
+
+        void divRemBurnikelZiegler(limb_t *q, limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+            // block size n = j * 2^k with j below the threshold, so that every recursion level halves evenly
+            size_t levels = 1;
+            while (bn / levels >= BURNIKEL_ZIEGLER_THRESHOLD)
+                levels <<= 1;
+            size_t n = (bn + levels - 1) / levels * levels;
+
+            // shift both operands so that the divisor fills exactly n limbs with its top bit set
+            size_t limbShift = n - bn;
+            unsigned bitShift = countLeadingZeros(b[bn - 1]);
+            auto v = makeScratch(n);
+            auto u = makeScratch(an + limbShift + 1);
+            if (bitShift) {
+                lshift(v.data() + limbShift, b, bn, bitShift);
+                u[an + limbShift] = lshift(u.data() + limbShift, a, an, bitShift);
+            } else {
+                std::copy(b, b + bn, v.begin() + limbShift);
+                std::copy(a, a + an, u.begin() + limbShift);
+            }
+
+            // split the dividend into t blocks of n limbs, the top block being below B^n / 2 <= v
+            size_t un = normalizedSize(u.data(), u.size());
+            size_t blocks = std::max<size_t>(2, (un * LIMB_BITS - countLeadingZeros(u[un - 1]) + n * LIMB_BITS)
+                                                / (n * LIMB_BITS));
+            u.resize(blocks * n, 0);
+
+            auto quotient = makeScratch(blocks * n);
+            auto z = makeScratch(u.data() + u.size() - 2 * n, u.data() + u.size());
+            auto rem = makeScratch(n);
+            for (size_t i = blocks - 1; i-- > 0;) {
+                divTwoByOne(quotient.data() + i * n, rem.data(), z.data(), v.data(), n);
+                if (i > 0) {
+                    std::copy(u.begin() + (i - 1) * n, u.begin() + i * n, z.begin());
+                    std::copy(rem.begin(), rem.end(), z.begin() + n);
+                }
+            }
+
+            std::copy(quotient.begin(), quotient.begin() + (an - bn + 1), q);
+            if (bitShift)
+                rshift(r, rem.data() + limbShift, bn, bitShift);
+            else
+                std::copy(rem.begin() + limbShift, rem.end(), r);
+        }
+    }
+}
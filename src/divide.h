@@ -0,0 +1,20 @@
+#pragma once
+
+#include "kernels.h"
+
+namespace BigNum {
+    namespace kernels {
+        // divisor and quotient sizes (in limbs) at which recursive division takes over from Knuth's algorithm
+        constexpr size_t BURNIKEL_ZIEGLER_THRESHOLD = 120;
+
+        // q[0..an-bn+1) = a / b and r[0..bn) = a % b for an >= bn >= 1 and b[bn-1] != 0;
+        // q and r must not overlap inputs
+        void divRem(limb_t *q, limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn);
+
+        // Knuth's algorithm D, requires bn >= 2
+        void divRemSchoolbook(limb_t *q, limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn);
+
+        // Burnikel-Ziegler recursive division, costs a small multiple of a multiplication; requires bn >= 2
+        void divRemBurnikelZiegler(limb_t *q, limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn);
+    }
+}
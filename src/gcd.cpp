@@ -0,0 +1,341 @@
+#include <algorithm>
+#include "Instrumentation.h"
+#include "gcd.h"
+#include "natural.h"
+
+namespace BigNum {
+    namespace kernels {
+        namespace {
+            void recordGcdAlgorithm(size_t n) {
+                if (n >= HGCD_THRESHOLD)
+                    BIGNUM_RECORD_ALGORITHM(GcdHalfGcd);
+                else
+                    BIGNUM_RECORD_ALGORITHM(GcdLehmer);
+            }
+
+            size_t wideBitLength(dlimb_t a) {
+                limb_t high = (limb_t) (a >> LIMB_BITS);
+                return high ? 2 * LIMB_BITS - countLeadingZeros(high) : LIMB_BITS - countLeadingZeros((limb_t) a);
+            }
+
+            limb_t gcdWord(limb_t a, limb_t b) {
+                // binary gcd, the common power of two is put back at the end
+                if (a == 0 || b == 0)
+                    return a | b;
+                unsigned shift = countTrailingZeros(a | b);
+                a >>= countTrailingZeros(a);
+                while (b) {
+                    b >>= countTrailingZeros(b);
+                    if (a > b)
+                        std::swap(a, b);
+                    b -= a;
+                }
+                return a << shift;
+            }
+
+            // 2x2 matrix with non-negative entries and determinant det = +-1 such that
+            // (a, b) before a reduction equals M * (a, b) after it
+            struct Matrix {
+                Natural m11 = makeScratch(), m12 = makeScratch(), m21 = makeScratch(), m22 = makeScratch();
+                int det = 1;
+
+                Matrix() {
+                    m11.push_back(1);
+                    m22.push_back(1);
+                }
+
+                bool isIdentity() const {
+                    return m12.empty() && m21.empty() && m11.size() == 1 && m11[0] == 1
+                           && m22.size() == 1 && m22[0] == 1;
+                }
+
+                const Natural &maxEntry() const {
+                    const Natural *res = &m11;
+                    for (const Natural *e : {&m12, &m21, &m22}) {
+                        if (compare(*e, *res) > 0)
+                            res = e;
+                    }
+                    return *res;
+                }
+
+                // M * [[q, 1], [1, 0]], the matrix of one Euclidean step with quotient q
+                void appendQuotient(const Natural &q) {
+                    Natural c1 = sum(product(m11, q), m12);
+                    Natural c2 = sum(product(m21, q), m22);
+                    m12 = std::move(m11);
+                    m22 = std::move(m21);
+                    m11 = std::move(c1);
+                    m21 = std::move(c2);
+                    det = -det;
+                }
+
+                // M * [[0, 1], [1, 0]]
+                void swapColumns() {
+                    std::swap(m11, m12);
+                    std::swap(m21, m22);
+                    det = -det;
+                }
+
+                Matrix operator*(const Matrix &oth) const {
+                    Matrix res;
+                    res.m11 = sum(product(m11, oth.m11), product(m12, oth.m21));
+                    res.m12 = sum(product(m11, oth.m12), product(m12, oth.m22));
+                    res.m21 = sum(product(m21, oth.m11), product(m22, oth.m21));
+                    res.m22 = sum(product(m21, oth.m12), product(m22, oth.m22));
+                    res.det = det * oth.det;
+                    return res;
+                }
+            };
+
+            // x = u * a - v * b, false if that is negative
+            bool crossDifference(Natural &x, const Natural &u, const Natural &a, const Natural &v,
+                                 const Natural &b) {
+                Natural left = product(u, a), right = product(v, b);
+                if (compare(left, right) < 0)
+                    return false;
+                x.assign(left.size(), 0);
+                if (!right.empty())
+                    sub(x.data(), left.data(), left.size(), right.data(), right.size());
+                else
+                    std::copy(left.begin(), left.end(), x.begin());
+                normalize(x);
+                return true;
+            }
+
+            // (a, b) = M^-1 * (a, b), false (leaving a and b alone) if a component would be negative
+            bool applyInverse(const Matrix &m, Natural &a, Natural &b) {
+                auto x = makeScratch(), y = makeScratch();
+                bool ok = m.det > 0 ? crossDifference(x, m.m22, a, m.m12, b) && crossDifference(y, m.m11, b, m.m21, a)
+                                    : crossDifference(x, m.m12, b, m.m22, a) && crossDifference(y, m.m21, a, m.m11, b);
+                if (!ok)
+                    return false;
+                a = std::move(x);
+                b = std::move(y);
+                return true;
+            }
+
+            // Lehmer matrix of the Euclidean steps that a and b agree on, taken from the leading 128 bits
+            // of a and the same bits of b; entries stay below 2^63. Steps stop by Jebelean's condition,
+            // which keeps every quotient valid for the full numbers. With bound set the steps also stop
+            // before the remainder gets within 2^bound of the cofactors, measured at the scale of a.
+            // Returns false if no step was made.
+            bool lehmerMatrix(const Natural &a, const Natural &b, Matrix &m, const size_t *bound = nullptr) {
+                size_t bits = bitLength(a);
+                size_t shift = bits > 2 * LIMB_BITS ? bits - 2 * LIMB_BITS : 0;
+                Natural top = shiftedRight(a, shift), bottom = shiftedRight(b, shift);
+                dlimb_t x = top.empty() ? 0 : top[0] | (top.size() > 1 ? (dlimb_t) top[1] << LIMB_BITS : 0);
+                dlimb_t y = bottom.empty() ? 0 : bottom[0] | (bottom.size() > 1 ? (dlimb_t) bottom[1] << LIMB_BITS : 0);
+
+                const dlimb_t limit = (dlimb_t) 1 << (LIMB_BITS - 1);
+                dlimb_t p11 = 1, p12 = 0, p21 = 0, p22 = 1;
+                int det = 1;
+                bool progress = false;
+                while (y != 0) {
+                    dlimb_t q = x / y;
+                    if (q >= limit)
+                        break;
+                    dlimb_t r = x - q * y;
+                    dlimb_t n11 = q * p11 + p12, n21 = q * p21 + p22;
+                    if (n11 >= limit || n21 >= limit)
+                        break;
+                    // the new remainder has cofactors (n21, n11), the previous one (p21, p11)
+                    if (r < std::max(n11, n21) || y - r < std::max(n11 + p11, n21 + p21))
+                        break;
+                    if (bound && wideBitLength(r) + shift < wideBitLength(std::max(n11, n21)) + *bound)
+                        break;
+                    p12 = p11;
+                    p22 = p21;
+                    p11 = n11;
+                    p21 = n21;
+                    det = -det;
+                    x = y;
+                    y = r;
+                    progress = true;
+                }
+                if (!progress)
+                    return false;
+
+                m.m11 = fromLimb((limb_t) p11);
+                m.m12 = fromLimb((limb_t) p12);
+                m.m21 = fromLimb((limb_t) p21);
+                m.m22 = fromLimb((limb_t) p22);
+                m.det = det;
+                return true;
+            }
+
+            void euclidStep(Natural &a, Natural &b, Natural &q, Matrix *track) {
+                auto r = makeScratch();
+                divRemNatural(a, b, q, r);
+                a = std::move(b);
+                b = std::move(r);
+                if (track)
+                    track->appendQuotient(q);
+            }
+
+            // a >= b >= 2 * |M|, the condition under which a matrix computed from leading bits reduces the
+            // full numbers too
+            bool stillReduced(const Natural &b, const Matrix &m) {
+                const Natural &top = m.maxEntry();
+                return compare(b, sum(top, top)) >= 0;
+            }
+
+            void restoreOrder(Natural &a, Natural &b, Matrix &m) {
+                if (compare(a, b) < 0) {
+                    std::swap(a, b);
+                    m.swapColumns();
+                }
+            }
+
+            // Lehmer and single Euclidean steps for as long as the reduced condition survives them
+            void reduceSteps(Natural &a, Natural &b, Matrix &m) {
+                auto q = makeScratch(), r = makeScratch();
+                while (!b.empty()) {
+                    // b * 2^-shift needs about bits(M) + bits(L) + 3 bits for b >= 2 * |M * L|
+                    size_t bound = bitLength(m.maxEntry()) + 3;
+                    Matrix lehmer;
+                    if (lehmerMatrix(a, b, lehmer, &bound)) {
+                        Natural x = a, y = b;
+                        Matrix next = m * lehmer;
+                        if (applyInverse(lehmer, x, y) && compare(x, y) >= 0 && stillReduced(y, next)) {
+                            a = std::move(x);
+                            b = std::move(y);
+                            m = std::move(next);
+                            continue;
+                        }
+                    }
+                    divRemNatural(a, b, q, r);
+                    Matrix next = m;
+                    next.appendQuotient(q);
+                    if (!stillReduced(r, next))
+                        break;
+                    a = std::move(b);
+                    b = std::move(r);
+                    m = std::move(next);
+                }
+            }
+
+            // reduces a >= b to about half the size of a while keeping b >= 2 * |M|, with two recursive
+            // calls on leading parts: one of the top half of the bits, one of the middle after the first
+            // reduction
+            void halfGcd(Natural &a, Natural &b, Matrix &m) {
+                size_t bits = bitLength(a);
+                if (b.empty() || bitLength(b) <= bits / 2 + 2)
+                    return;
+                if (a.size() < HGCD_THRESHOLD) {
+                    reduceSteps(a, b, m);
+                    return;
+                }
+
+                // b ends up at least |M| * 2^shift >= 2 * |M| for the first call and 4 * |M| * |M2| for the
+                // second, so the combined matrix stays reduced
+                size_t shift = bits / 2;
+                Natural a1 = shiftedRight(a, shift), b1 = shiftedRight(b, shift);
+                Matrix m1;
+                halfGcd(a1, b1, m1);
+                if (!m1.isIdentity() && applyInverse(m1, a, b)) {
+                    m = std::move(m1);
+                    restoreOrder(a, b, m);
+                }
+
+                if (!b.empty()) {
+                    auto q = makeScratch(), r = makeScratch();
+                    divRemNatural(a, b, q, r);
+                    Matrix next = m;
+                    next.appendQuotient(q);
+                    if (!stillReduced(r, next))
+                        return;
+                    a = std::move(b);
+                    b = std::move(r);
+                    m = std::move(next);
+                }
+
+                shift = bitLength(m.maxEntry()) + 2;
+                if (bitLength(a) > shift + 2 * LIMB_BITS) {
+                    Natural a2 = shiftedRight(a, shift), b2 = shiftedRight(b, shift);
+                    Matrix m2;
+                    halfGcd(a2, b2, m2);
+                    if (!m2.isIdentity() && applyInverse(m2, a, b)) {
+                        m = m * m2;
+                        restoreOrder(a, b, m);
+                    }
+                }
+                reduceSteps(a, b, m);
+            }
+
+            // Euclid's algorithm on a >= b, moving by half-gcd matrices for large operands and by Lehmer
+            // matrices otherwise; with track the product of all steps is accumulated
+            Natural gcdLoop(Natural a, Natural b, Matrix *track) {
+                auto q = makeScratch();
+                while (!b.empty()) {
+                    if (b.size() == 1 && !track) {
+                        limb_t rem = divRem1(a.data(), a.data(), a.size(), b[0]);
+                        a.assign(1, gcdWord(b[0], rem));
+                        return a;
+                    }
+                    if (a.size() - b.size() > 1) {
+                        euclidStep(a, b, q, track);
+                        continue;
+                    }
+                    if (a.size() >= HGCD_THRESHOLD) {
+                        Matrix m;
+                        halfGcd(a, b, m);
+                        if (!m.isIdentity()) {
+                            if (track)
+                                *track = *track * m;
+                            if (!b.empty())
+                                euclidStep(a, b, q, track);
+                            continue;
+                        }
+                    }
+                    Matrix lehmer;
+                    if (lehmerMatrix(a, b, lehmer)) {
+                        Natural x = a, y = b;
+                        if (applyInverse(lehmer, x, y) && compare(x, y) >= 0 && compare(y, b) < 0) {
+                            a = std::move(x);
+                            b = std::move(y);
+                            if (track)
+                                *track = *track * lehmer;
+                            continue;
+                        }
+                    }
+                    euclidStep(a, b, q, track);
+                }
+                return a;
+            }
+        }
+
+        Scratch gcd(const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+            recordGcdAlgorithm(std::max(an, bn));
+            Natural x = makeScratch(a, a + an), y = makeScratch(b, b + bn);
+            if (compare(x, y) < 0)
+                std::swap(x, y);
+            return gcdLoop(std::move(x), std::move(y), nullptr);
+        }
+
+        Scratch gcdExt(const limb_t *a, size_t an, const limb_t *b, size_t bn, Scratch &x) {
+            recordGcdAlgorithm(std::max(an, bn));
+            Natural u = makeScratch(a, a + an), v = makeScratch(b, b + bn);
+            Matrix track;
+            bool swapped = compare(u, v) < 0;
+            if (swapped) {
+                std::swap(u, v);
+                track.swapColumns();
+            }
+            Natural g = gcdLoop(std::move(u), std::move(v), &track);
+
+            // (a, b) = M * (g, 0) makes g = det * (m22 * a - m12 * b), so a * det * m22 = g (mod b)
+            Natural bound = makeScratch(), rem = makeScratch();
+            divRemNatural(makeScratch(b, b + bn), g, bound, rem);
+            Natural cofactor = makeScratch();
+            divRemNatural(track.m22, bound, rem, cofactor);
+            if (track.det < 0 && !cofactor.empty()) {
+                Natural flipped = makeScratch(bound.size());
+                sub(flipped.data(), bound.data(), bound.size(), cofactor.data(), cofactor.size());
+                normalize(flipped);
+                cofactor = std::move(flipped);
+            }
+            x = std::move(cofactor);
+            return g;
+        }
+    }
+}
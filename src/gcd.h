@@ -0,0 +1,17 @@
+#pragma once
+
+#include "kernels.h"
+
+namespace BigNum {
+    namespace kernels {
+        // operand size (in limbs) from which the gcd reduces by the subquadratic half-gcd
+        constexpr size_t HGCD_THRESHOLD = 800;
+
+        // gcd of a[0..an) and b[0..bn) for normalized operands, not both zero; the result is normalized
+        Scratch gcd(const limb_t *a, size_t an, const limb_t *b, size_t bn);
+
+        // gcd of positive normalized a and b, also setting x to the cofactor with a * x = gcd (mod b)
+        // and 0 <= x < b / gcd
+        Scratch gcdExt(const limb_t *a, size_t an, const limb_t *b, size_t bn, Scratch &x);
+    }
+}
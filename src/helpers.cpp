@@ -2,21 +2,23 @@
 
 
 namespace BigNum {
+    namespace {
+        bool isSpace(char ch) {
+            return std::isspace(static_cast<unsigned char>(ch));
+        }
+    }
 
-    void ltrim(std::string &s) {
-        s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](int ch) {
-            return !std::isspace(ch);
-        }));
+    std::string_view ltrim(std::string_view s) {
+        auto first = std::find_if_not(s.begin(), s.end(), isSpace);
+        return s.substr(static_cast<size_t>(first - s.begin()));
     }
 
-    void rtrim(std::string &s) {
-        s.erase(std::find_if(s.rbegin(), s.rend(), [](int ch) {
-            return !std::isspace(ch);
-        }).base(), s.end());
+    std::string_view rtrim(std::string_view s) {
+        auto last = std::find_if_not(s.rbegin(), s.rend(), isSpace);
+        return s.substr(0, static_cast<size_t>(s.rend() - last));
     }
 
-    void trim(std::string &s) {
-        ltrim(s);
-        rtrim(s);
+    std::string_view trim(std::string_view s) {
+        return rtrim(ltrim(s));
     }
 }
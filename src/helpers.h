@@ -1,14 +1,14 @@
 #include <algorithm>
 #include <cctype>
-#include <locale>
+#include <string_view>
 
 namespace BigNum {
-    // from https://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring
+    // views of s without the leading, trailing or both kinds of whitespace
 
-    void ltrim(std::string &s);
+    std::string_view ltrim(std::string_view s);
 
-    void rtrim(std::string &s);
+    std::string_view rtrim(std::string_view s);
 
-    void trim(std::string &s);
+    std::string_view trim(std::string_view s);
 
 }
@@ -0,0 +1,291 @@
+#include "kernels.h"
+
+namespace BigNum {
+    namespace kernels {
+        namespace {
+            // divisor with its top bit set and the reciprocal floor((2^128 - 1) / d) - 2^64, dividing two
+            // limbs by one with multiplications (Moller and Granlund, "Improved division by invariant integers")
+            class LimbDivisor {
+            public:
+                explicit LimbDivisor(limb_t d) : d(d), v((limb_t) (~dlimb_t(0) / d)) {}
+
+                // quotient of (high, low) by d for high < d, storing the remainder in rem
+                limb_t divide(limb_t high, limb_t low, limb_t &rem) const {
+                    dlimb_t p = (dlimb_t) v * high + (((dlimb_t) high << LIMB_BITS) | low);
+                    limb_t q = (limb_t) (p >> LIMB_BITS) + 1;
+                    limb_t r = low - q * d;
+                    if (r > (limb_t) p) {
+                        q--;
+                        r += d;
+                    }
+                    if (r >= d) {
+                        q++;
+                        r -= d;
+                    }
+                    rem = r;
+                    return q;
+                }
+
+            private:
+                limb_t d;
+                limb_t v;
+            };
+
+            limb_t addNPortable(limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+                limb_t carry = 0;
+                for (size_t i = 0; i < n; i++) {
+                    limb_t s = a[i] + carry;
+                    carry = s < carry;
+                    r[i] = s + b[i];
+                    carry += r[i] < s;
+                }
+                return carry;
+            }
+
+            limb_t subNPortable(limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+                limb_t borrow = 0;
+                for (size_t i = 0; i < n; i++) {
+                    limb_t d = a[i] - b[i];
+                    limb_t next = a[i] < b[i];
+                    r[i] = d - borrow;
+                    borrow = next + (d < borrow);
+                }
+                return borrow;
+            }
+
+            limb_t mul1Portable(limb_t *r, const limb_t *a, size_t n, limb_t b) {
+                limb_t carry = 0;
+                for (size_t i = 0; i < n; i++) {
+                    dlimb_t p = (dlimb_t) a[i] * b + carry;
+                    r[i] = (limb_t) p;
+                    carry = (limb_t) (p >> LIMB_BITS);
+                }
+                return carry;
+            }
+
+            limb_t addMul1Portable(limb_t *r, const limb_t *a, size_t n, limb_t b) {
+                limb_t carry = 0;
+                for (size_t i = 0; i < n; i++) {
+                    dlimb_t p = (dlimb_t) a[i] * b + r[i] + carry;
+                    r[i] = (limb_t) p;
+                    carry = (limb_t) (p >> LIMB_BITS);
+                }
+                return carry;
+            }
+
+            size_t popcountPortable(const limb_t *a, size_t n) {
+                size_t count = 0;
+                for (size_t i = 0; i < n; i++) {
+                    // bit counts of 2, 4 and 8 bit fields, summed into the top byte by the multiplication
+                    limb_t x = a[i] - ((a[i] >> 1) & 0x5555555555555555);
+                    x = (x & 0x3333333333333333) + ((x >> 2) & 0x3333333333333333);
+                    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0f;
+                    count += (x * 0x0101010101010101) >> 56;
+                }
+                return count;
+            }
+        }
+
+        const KernelSet PORTABLE_KERNELS = {"portable", addNPortable, subNPortable, mul1Portable, addMul1Portable,
+                                            popcountPortable};
+
+        const KernelSet &activeKernels() {
+            static const KernelSet &active = *supportedKernels().back();
+            return active;
+        }
+
+        std::vector<const KernelSet *> supportedKernels() {
+            std::vector<const KernelSet *> res = {&PORTABLE_KERNELS};
+#if BIGNUM_X86_KERNELS
+            __builtin_cpu_init();
+            bool popcnt = __builtin_cpu_supports("popcnt");
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2") && popcnt)
+                res.push_back(&AVX2_KERNELS);
+            if (__builtin_cpu_supports("adx") && __builtin_cpu_supports("bmi2") && popcnt)
+                res.push_back(&ADX_KERNELS);
+#endif
+            return res;
+        }
+
+        size_t normalizedSize(const limb_t *a, size_t n) {
+            while (n > 0 && a[n - 1] == 0)
+                n--;
+            return n;
+        }
+
+        int compare(const limb_t *a, const limb_t *b, size_t n) {
+            while (n-- > 0) {
+                if (a[n] != b[n])
+                    return a[n] > b[n] ? 1 : -1;
+            }
+            return 0;
+        }
+
+        int compare(const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+            if (an != bn)
+                return an > bn ? 1 : -1;
+            return compare(a, b, an);
+        }
+
+        limb_t addN(limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+            return activeKernels().addN(r, a, b, n);
+        }
+
+        limb_t add(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+            limb_t carry = addN(r, a, b, bn);
+            return add1(r + bn, a + bn, an - bn, carry);
+        }
+
+        limb_t add1(limb_t *r, const limb_t *a, size_t n, limb_t b) {
+            size_t i = 0;
+            for (; i < n && b; i++) {
+                r[i] = a[i] + b;
+                b = r[i] < b;
+            }
+            if (r != a) {
+                for (; i < n; i++)
+                    r[i] = a[i];
+            }
+            return b;
+        }
+
+        limb_t subN(limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+            return activeKernels().subN(r, a, b, n);
+        }
+
+        limb_t sub(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+            limb_t borrow = subN(r, a, b, bn);
+            return sub1(r + bn, a + bn, an - bn, borrow);
+        }
+
+        limb_t sub1(limb_t *r, const limb_t *a, size_t n, limb_t b) {
+            size_t i = 0;
+            for (; i < n && b; i++) {
+                limb_t next = a[i] < b;
+                r[i] = a[i] - b;
+                b = next;
+            }
+            if (r != a) {
+                for (; i < n; i++)
+                    r[i] = a[i];
+            }
+            return b;
+        }
+
+        limb_t mul1(limb_t *r, const limb_t *a, size_t n, limb_t b) {
+            return activeKernels().mul1(r, a, n, b);
+        }
+
+        limb_t addMul1(limb_t *r, const limb_t *a, size_t n, limb_t b) {
+            return activeKernels().addMul1(r, a, n, b);
+        }
+
+        limb_t subMul1(limb_t *r, const limb_t *a, size_t n, limb_t b) {
+            limb_t borrow = 0;
+            for (size_t i = 0; i < n; i++) {
+                dlimb_t p = (dlimb_t) a[i] * b + borrow;
+                limb_t lo = (limb_t) p;
+                borrow = (limb_t) (p >> LIMB_BITS) + (r[i] < lo);
+                r[i] -= lo;
+            }
+            return borrow;
+        }
+
+        void mulBasecase(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+            r[an] = mul1(r, a, an, b[0]);
+            for (size_t i = 1; i < bn; i++)
+                r[an + i] = addMul1(r + i, a, an, b[i]);
+        }
+
+        void divExact1(limb_t *r, const limb_t *a, size_t n, limb_t d) {
+            // inverse of d modulo 2^64 by Newton iteration, each step doubles the correct bits
+            limb_t inverse = d;
+            for (int i = 0; i < 5; i++)
+                inverse *= 2 - d * inverse;
+
+            limb_t borrow = 0;
+            for (size_t i = 0; i < n; i++) {
+                limb_t under = a[i] < borrow;
+                limb_t q = (a[i] - borrow) * inverse;
+                r[i] = q;
+                borrow = (limb_t) (((dlimb_t) q * d) >> LIMB_BITS) + under;
+            }
+        }
+
+        // the dividend is shifted along with d so that d has its top bit set, then every limb costs two
+        // multiplications by the reciprocal instead of a 128-bit division
+        limb_t divRem1(limb_t *q, const limb_t *a, size_t n, limb_t d) {
+            if (n == 0)
+                return 0;
+            unsigned shift = countLeadingZeros(d);
+            LimbDivisor divisor(d << shift);
+            limb_t rem = shift ? a[n - 1] >> (LIMB_BITS - shift) : 0;
+            while (n-- > 0) {
+                limb_t low = shift && n ? a[n - 1] >> (LIMB_BITS - shift) : 0;
+                q[n] = divisor.divide(rem, (a[n] << shift) | low, rem);
+            }
+            return rem >> shift;
+        }
+
+        limb_t mod1(const limb_t *a, size_t n, limb_t d) {
+            if (n == 0)
+                return 0;
+            unsigned shift = countLeadingZeros(d);
+            LimbDivisor divisor(d << shift);
+            limb_t rem = shift ? a[n - 1] >> (LIMB_BITS - shift) : 0;
+            while (n-- > 0) {
+                limb_t low = shift && n ? a[n - 1] >> (LIMB_BITS - shift) : 0;
+                divisor.divide(rem, (a[n] << shift) | low, rem);
+            }
+            return rem >> shift;
+        }
+
+        limb_t lshift(limb_t *r, const limb_t *a, size_t n, unsigned shift) {
+            limb_t out = a[n - 1] >> (LIMB_BITS - shift);
+            for (size_t i = n - 1; i > 0; i--)
+                r[i] = (a[i] << shift) | (a[i - 1] >> (LIMB_BITS - shift));
+            r[0] = a[0] << shift;
+            return out;
+        }
+
+        limb_t rshift(limb_t *r, const limb_t *a, size_t n, unsigned shift) {
+            limb_t out = a[0] << (LIMB_BITS - shift);
+            for (size_t i = 0; i + 1 < n; i++)
+                r[i] = (a[i] >> shift) | (a[i + 1] << (LIMB_BITS - shift));
+            r[n - 1] = a[n - 1] >> shift;
+            return out;
+        }
+
+        void andN(limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+            for (size_t i = 0; i < n; i++)
+                r[i] = a[i] & b[i];
+        }
+
+        void iorN(limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+            for (size_t i = 0; i < n; i++)
+                r[i] = a[i] | b[i];
+        }
+
+        void xorN(limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+            for (size_t i = 0; i < n; i++)
+                r[i] = a[i] ^ b[i];
+        }
+
+        void comN(limb_t *r, const limb_t *a, size_t n) {
+            for (size_t i = 0; i < n; i++)
+                r[i] = ~a[i];
+        }
+
+        size_t popcount(const limb_t *a, size_t n) {
+            return activeKernels().popcount(a, n);
+        }
+
+        unsigned countLeadingZeros(limb_t x) {
+            return x ? __builtin_clzll(x) : LIMB_BITS;
+        }
+
+        unsigned countTrailingZeros(limb_t x) {
+            return x ? __builtin_ctzll(x) : LIMB_BITS;
+        }
+    }
+}
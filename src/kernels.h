@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "LimbResources.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define BIGNUM_X86_KERNELS 1
+#else
+#define BIGNUM_X86_KERNELS 0
+#endif
+
+namespace BigNum {
+    namespace kernels {
+        using limb_t = uint64_t;
+        using dlimb_t = unsigned __int128;
+
+        constexpr unsigned LIMB_BITS = 64;
+
+        // temporary limb buffer of the algorithms, allocated from the thread's current resource
+        using Scratch = std::pmr::vector<limb_t>;
+
+        inline Scratch makeScratch(size_t n = 0) {
+            return Scratch(n, 0, currentResource());
+        }
+
+        inline Scratch makeScratch(const limb_t *first, const limb_t *last) {
+            return Scratch(first, last, currentResource());
+        }
+
+        // all functions operate on little-endian limb arrays; output may alias an input of the same start
+
+        // size without most significant zero limbs
+        size_t normalizedSize(const limb_t *a, size_t n);
+
+        int compare(const limb_t *a, const limb_t *b, size_t n);
+
+        int compare(const limb_t *a, size_t an, const limb_t *b, size_t bn);
+
+        // r = a + b, returns carry
+        limb_t addN(limb_t *r, const limb_t *a, const limb_t *b, size_t n);
+
+        // r[0..an) = a + b where an >= bn, returns carry
+        limb_t add(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn);
+
+        limb_t add1(limb_t *r, const limb_t *a, size_t n, limb_t b);
+
+        // r = a - b, returns borrow
+        limb_t subN(limb_t *r, const limb_t *a, const limb_t *b, size_t n);
+
+        // r[0..an) = a - b where an >= bn, returns borrow
+        limb_t sub(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn);
+
+        limb_t sub1(limb_t *r, const limb_t *a, size_t n, limb_t b);
+
+        // r = a * b, returns high limb
+        limb_t mul1(limb_t *r, const limb_t *a, size_t n, limb_t b);
+
+        // r += a * b, returns high limb
+        limb_t addMul1(limb_t *r, const limb_t *a, size_t n, limb_t b);
+
+        // r -= a * b, returns borrow limb
+        limb_t subMul1(limb_t *r, const limb_t *a, size_t n, limb_t b);
+
+        // r[0..an+bn) = a * b, r must not overlap inputs
+        void mulBasecase(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn);
+
+        // r = a / d for odd d dividing a exactly
+        void divExact1(limb_t *r, const limb_t *a, size_t n, limb_t d);
+
+        // q = a / d, returns remainder; q may be a
+        limb_t divRem1(limb_t *q, const limb_t *a, size_t n, limb_t d);
+
+        // a mod d without computing the quotient
+        limb_t mod1(const limb_t *a, size_t n, limb_t d);
+
+        // r = a << shift for 0 < shift < LIMB_BITS, returns bits shifted out
+        limb_t lshift(limb_t *r, const limb_t *a, size_t n, unsigned shift);
+
+        // r = a >> shift for 0 < shift < LIMB_BITS, returns bits shifted out (in the high end of the limb)
+        limb_t rshift(limb_t *r, const limb_t *a, size_t n, unsigned shift);
+
+        // r = a & b, r = a | b, r = a ^ b and r = ~a limb by limb
+        void andN(limb_t *r, const limb_t *a, const limb_t *b, size_t n);
+
+        void iorN(limb_t *r, const limb_t *a, const limb_t *b, size_t n);
+
+        void xorN(limb_t *r, const limb_t *a, const limb_t *b, size_t n);
+
+        void comN(limb_t *r, const limb_t *a, size_t n);
+
+        // number of set bits in a[0..n)
+        size_t popcount(const limb_t *a, size_t n);
+
+        unsigned countLeadingZeros(limb_t x);
+
+        unsigned countTrailingZeros(limb_t x);
+
+        // one implementation of the hot primitives addN, subN, mul1, addMul1 and popcount; every call above goes
+        // through the best set the CPU supports, detected on first use
+        struct KernelSet {
+            const char *name;
+            limb_t (*addN)(limb_t *r, const limb_t *a, const limb_t *b, size_t n);
+            limb_t (*subN)(limb_t *r, const limb_t *a, const limb_t *b, size_t n);
+            limb_t (*mul1)(limb_t *r, const limb_t *a, size_t n, limb_t b);
+            limb_t (*addMul1)(limb_t *r, const limb_t *a, size_t n, limb_t b);
+            size_t (*popcount)(const limb_t *a, size_t n);
+        };
+
+        extern const KernelSet PORTABLE_KERNELS;
+
+#if BIGNUM_X86_KERNELS
+        // AVX2 carry-lookahead addition and subtraction with BMI2 mulx multiplication and popcnt
+        extern const KernelSet AVX2_KERNELS;
+
+        // adc/sbb addition and subtraction with mulx multiplication over two adcx/adox carry chains and popcnt
+        extern const KernelSet ADX_KERNELS;
+#endif
+
+        const KernelSet &activeKernels();
+
+        // sets that can run on this CPU, from the portable one to the preferred one
+        std::vector<const KernelSet *> supportedKernels();
+    }
+}
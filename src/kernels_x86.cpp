@@ -0,0 +1,319 @@
+#include "kernels.h"
+
+#if BIGNUM_X86_KERNELS
+
+#include <immintrin.h>
+
+namespace BigNum {
+    namespace kernels {
+        namespace {
+            // the unrolled loops below handle whole blocks of four limbs, the rest is finished here
+            limb_t addTail(limb_t *r, const limb_t *a, const limb_t *b, size_t n, limb_t carry) {
+                for (size_t i = 0; i < n; i++) {
+                    limb_t s = a[i] + carry;
+                    carry = s < carry;
+                    r[i] = s + b[i];
+                    carry += r[i] < s;
+                }
+                return carry;
+            }
+
+            limb_t subTail(limb_t *r, const limb_t *a, const limb_t *b, size_t n, limb_t borrow) {
+                for (size_t i = 0; i < n; i++) {
+                    limb_t d = a[i] - b[i];
+                    limb_t next = a[i] < b[i];
+                    r[i] = d - borrow;
+                    borrow = next + (d < borrow);
+                }
+                return borrow;
+            }
+
+            limb_t mulTail(limb_t *r, const limb_t *a, size_t n, limb_t b, limb_t carry) {
+                for (size_t i = 0; i < n; i++) {
+                    dlimb_t p = (dlimb_t) a[i] * b + carry;
+                    r[i] = (limb_t) p;
+                    carry = (limb_t) (p >> LIMB_BITS);
+                }
+                return carry;
+            }
+
+            limb_t addMulTail(limb_t *r, const limb_t *a, size_t n, limb_t b, limb_t carry) {
+                for (size_t i = 0; i < n; i++) {
+                    dlimb_t p = (dlimb_t) a[i] * b + r[i] + carry;
+                    r[i] = (limb_t) p;
+                    carry = (limb_t) (p >> LIMB_BITS);
+                }
+                return carry;
+            }
+
+            // the loops count blocks in rcx with lea and jrcxz, which leave the carry flags alone
+
+            limb_t addNAdc(limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+                size_t blocks = n / 4;
+                limb_t carry = 0;
+                if (blocks) {
+                    asm volatile(
+                            "xor %k[carry], %k[carry]\n\t"
+                            "1:\n\t"
+                            "mov (%[a]), %%r8\n\t"
+                            "mov 8(%[a]), %%r9\n\t"
+                            "mov 16(%[a]), %%r10\n\t"
+                            "mov 24(%[a]), %%r11\n\t"
+                            "adc (%[b]), %%r8\n\t"
+                            "adc 8(%[b]), %%r9\n\t"
+                            "adc 16(%[b]), %%r10\n\t"
+                            "adc 24(%[b]), %%r11\n\t"
+                            "mov %%r8, (%[r])\n\t"
+                            "mov %%r9, 8(%[r])\n\t"
+                            "mov %%r10, 16(%[r])\n\t"
+                            "mov %%r11, 24(%[r])\n\t"
+                            "lea 32(%[a]), %[a]\n\t"
+                            "lea 32(%[b]), %[b]\n\t"
+                            "lea 32(%[r]), %[r]\n\t"
+                            "lea -1(%%rcx), %%rcx\n\t"
+                            "jrcxz 2f\n\t"
+                            "jmp 1b\n\t"
+                            "2:\n\t"
+                            "setc %b[carry]"
+                            : [r] "+r"(r), [a] "+r"(a), [b] "+r"(b), "+c"(blocks), [carry] "=&r"(carry)
+                            :
+                            : "r8", "r9", "r10", "r11", "cc", "memory");
+                }
+                return addTail(r, a, b, n % 4, carry);
+            }
+
+            limb_t subNSbb(limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+                size_t blocks = n / 4;
+                limb_t borrow = 0;
+                if (blocks) {
+                    asm volatile(
+                            "xor %k[borrow], %k[borrow]\n\t"
+                            "1:\n\t"
+                            "mov (%[a]), %%r8\n\t"
+                            "mov 8(%[a]), %%r9\n\t"
+                            "mov 16(%[a]), %%r10\n\t"
+                            "mov 24(%[a]), %%r11\n\t"
+                            "sbb (%[b]), %%r8\n\t"
+                            "sbb 8(%[b]), %%r9\n\t"
+                            "sbb 16(%[b]), %%r10\n\t"
+                            "sbb 24(%[b]), %%r11\n\t"
+                            "mov %%r8, (%[r])\n\t"
+                            "mov %%r9, 8(%[r])\n\t"
+                            "mov %%r10, 16(%[r])\n\t"
+                            "mov %%r11, 24(%[r])\n\t"
+                            "lea 32(%[a]), %[a]\n\t"
+                            "lea 32(%[b]), %[b]\n\t"
+                            "lea 32(%[r]), %[r]\n\t"
+                            "lea -1(%%rcx), %%rcx\n\t"
+                            "jrcxz 2f\n\t"
+                            "jmp 1b\n\t"
+                            "2:\n\t"
+                            "setc %b[borrow]"
+                            : [r] "+r"(r), [a] "+r"(a), [b] "+r"(b), "+c"(blocks), [borrow] "=&r"(borrow)
+                            :
+                            : "r8", "r9", "r10", "r11", "cc", "memory");
+                }
+                return subTail(r, a, b, n % 4, borrow);
+            }
+
+            // one carry chain: the low half of a[i] * b plus the high half of a[i - 1] * b
+            __attribute__((target("bmi2")))
+            limb_t mul1Mulx(limb_t *r, const limb_t *a, size_t n, limb_t b) {
+                size_t blocks = n / 4;
+                limb_t carry = 0;
+                if (blocks) {
+                    asm volatile(
+                            "xor %%r8d, %%r8d\n\t"
+                            "1:\n\t"
+                            "mulx (%[a]), %%r8, %%r9\n\t"
+                            "adc %[carry], %%r8\n\t"
+                            "mov %%r8, (%[r])\n\t"
+                            "mulx 8(%[a]), %%r10, %[carry]\n\t"
+                            "adc %%r9, %%r10\n\t"
+                            "mov %%r10, 8(%[r])\n\t"
+                            "mulx 16(%[a]), %%r8, %%r9\n\t"
+                            "adc %[carry], %%r8\n\t"
+                            "mov %%r8, 16(%[r])\n\t"
+                            "mulx 24(%[a]), %%r10, %[carry]\n\t"
+                            "adc %%r9, %%r10\n\t"
+                            "mov %%r10, 24(%[r])\n\t"
+                            "lea 32(%[a]), %[a]\n\t"
+                            "lea 32(%[r]), %[r]\n\t"
+                            "lea -1(%%rcx), %%rcx\n\t"
+                            "jrcxz 2f\n\t"
+                            "jmp 1b\n\t"
+                            "2:\n\t"
+                            "adc $0, %[carry]"
+                            : [r] "+r"(r), [a] "+r"(a), "+c"(blocks), [carry] "+r"(carry)
+                            : "d"(b)
+                            : "r8", "r9", "r10", "cc", "memory");
+                }
+                return mulTail(r, a, n % 4, b, carry);
+            }
+
+            // without adox the two additions into each limb share the carry flag, so each is closed
+            // into the high half right away
+            __attribute__((target("bmi2")))
+            limb_t addMul1Mulx(limb_t *r, const limb_t *a, size_t n, limb_t b) {
+                size_t blocks = n / 4;
+                limb_t carry = 0;
+                if (blocks) {
+                    asm volatile(
+                            "1:\n\t"
+                            "mulx (%[a]), %%r8, %%r9\n\t"
+                            "add %[carry], %%r8\n\t"
+                            "adc $0, %%r9\n\t"
+                            "add (%[r]), %%r8\n\t"
+                            "adc $0, %%r9\n\t"
+                            "mov %%r8, (%[r])\n\t"
+                            "mulx 8(%[a]), %%r8, %[carry]\n\t"
+                            "add %%r9, %%r8\n\t"
+                            "adc $0, %[carry]\n\t"
+                            "add 8(%[r]), %%r8\n\t"
+                            "adc $0, %[carry]\n\t"
+                            "mov %%r8, 8(%[r])\n\t"
+                            "mulx 16(%[a]), %%r8, %%r9\n\t"
+                            "add %[carry], %%r8\n\t"
+                            "adc $0, %%r9\n\t"
+                            "add 16(%[r]), %%r8\n\t"
+                            "adc $0, %%r9\n\t"
+                            "mov %%r8, 16(%[r])\n\t"
+                            "mulx 24(%[a]), %%r8, %[carry]\n\t"
+                            "add %%r9, %%r8\n\t"
+                            "adc $0, %[carry]\n\t"
+                            "add 24(%[r]), %%r8\n\t"
+                            "adc $0, %[carry]\n\t"
+                            "mov %%r8, 24(%[r])\n\t"
+                            "lea 32(%[a]), %[a]\n\t"
+                            "lea 32(%[r]), %[r]\n\t"
+                            "dec %[blocks]\n\t"
+                            "jnz 1b"
+                            : [r] "+r"(r), [a] "+r"(a), [blocks] "+r"(blocks), [carry] "+r"(carry)
+                            : "d"(b)
+                            : "r8", "r9", "cc", "memory");
+                }
+                return addMulTail(r, a, n % 4, b, carry);
+            }
+
+            // two independent carry chains: adcx adds the high half of a[i - 1] * b to the low half of
+            // a[i] * b while adox adds the result into r[i]
+            __attribute__((target("adx,bmi2")))
+            limb_t addMul1Adx(limb_t *r, const limb_t *a, size_t n, limb_t b) {
+                size_t blocks = n / 4;
+                limb_t carry = 0;
+                if (blocks) {
+                    asm volatile(
+                            "xor %%r8d, %%r8d\n\t"
+                            "1:\n\t"
+                            "mulx (%[a]), %%r8, %%r9\n\t"
+                            "adcx %[carry], %%r8\n\t"
+                            "adox (%[r]), %%r8\n\t"
+                            "mov %%r8, (%[r])\n\t"
+                            "mulx 8(%[a]), %%r10, %[carry]\n\t"
+                            "adcx %%r9, %%r10\n\t"
+                            "adox 8(%[r]), %%r10\n\t"
+                            "mov %%r10, 8(%[r])\n\t"
+                            "mulx 16(%[a]), %%r8, %%r9\n\t"
+                            "adcx %[carry], %%r8\n\t"
+                            "adox 16(%[r]), %%r8\n\t"
+                            "mov %%r8, 16(%[r])\n\t"
+                            "mulx 24(%[a]), %%r10, %[carry]\n\t"
+                            "adcx %%r9, %%r10\n\t"
+                            "adox 24(%[r]), %%r10\n\t"
+                            "mov %%r10, 24(%[r])\n\t"
+                            "lea 32(%[a]), %[a]\n\t"
+                            "lea 32(%[r]), %[r]\n\t"
+                            "lea -1(%%rcx), %%rcx\n\t"
+                            "jrcxz 2f\n\t"
+                            "jmp 1b\n\t"
+                            "2:\n\t"
+                            // mov leaves the flags alone, both pending carries land in the high limb
+                            "mov $0, %%r8d\n\t"
+                            "adcx %%r8, %[carry]\n\t"
+                            "adox %%r8, %[carry]"
+                            : [r] "+r"(r), [a] "+r"(a), "+c"(blocks), [carry] "+r"(carry)
+                            : "d"(b)
+                            : "r8", "r9", "r10", "cc", "memory");
+                }
+                return addMulTail(r, a, n % 4, b, carry);
+            }
+
+            // carry into each of the four lanes given lanes that generate a carry and lanes that pass
+            // one on; treating the lanes as the bits of a 4-bit addition resolves the whole block at once
+            inline unsigned lookahead(unsigned generate, unsigned propagate, unsigned &carry) {
+                unsigned x = generate | propagate;
+                unsigned sum = x + generate + carry;
+                carry = sum >> 4;
+                return (sum ^ x ^ generate) & 0xF;
+            }
+
+            __attribute__((target("avx2")))
+            inline __m256i laneMask(unsigned bits) {
+                // lane i holds bit i of bits
+                __m256i shifted = _mm256_srlv_epi64(_mm256_set1_epi64x(bits), _mm256_setr_epi64x(0, 1, 2, 3));
+                return _mm256_and_si256(shifted, _mm256_set1_epi64x(1));
+            }
+
+            __attribute__((target("avx2")))
+            limb_t addNAvx2(limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+                const __m256i bias = _mm256_set1_epi64x((long long) (1ull << 63));
+                const __m256i ones = _mm256_set1_epi64x(-1);
+                unsigned carry = 0;
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    __m256i x = _mm256_loadu_si256((const __m256i *) (a + i));
+                    __m256i y = _mm256_loadu_si256((const __m256i *) (b + i));
+                    __m256i s = _mm256_add_epi64(x, y);
+                    // unsigned s < x through the signed compare of biased values
+                    __m256i generate = _mm256_cmpgt_epi64(_mm256_xor_si256(x, bias), _mm256_xor_si256(s, bias));
+                    __m256i propagate = _mm256_cmpeq_epi64(s, ones);
+                    unsigned in = lookahead(_mm256_movemask_pd(_mm256_castsi256_pd(generate)),
+                                            _mm256_movemask_pd(_mm256_castsi256_pd(propagate)), carry);
+                    _mm256_storeu_si256((__m256i *) (r + i), _mm256_add_epi64(s, laneMask(in)));
+                }
+                return addTail(r + i, a + i, b + i, n - i, carry);
+            }
+
+            __attribute__((target("avx2")))
+            limb_t subNAvx2(limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+                const __m256i bias = _mm256_set1_epi64x((long long) (1ull << 63));
+                const __m256i zero = _mm256_setzero_si256();
+                unsigned borrow = 0;
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    __m256i x = _mm256_loadu_si256((const __m256i *) (a + i));
+                    __m256i y = _mm256_loadu_si256((const __m256i *) (b + i));
+                    __m256i d = _mm256_sub_epi64(x, y);
+                    __m256i generate = _mm256_cmpgt_epi64(_mm256_xor_si256(y, bias), _mm256_xor_si256(x, bias));
+                    __m256i propagate = _mm256_cmpeq_epi64(d, zero);
+                    unsigned in = lookahead(_mm256_movemask_pd(_mm256_castsi256_pd(generate)),
+                                            _mm256_movemask_pd(_mm256_castsi256_pd(propagate)), borrow);
+                    _mm256_storeu_si256((__m256i *) (r + i), _mm256_sub_epi64(d, laneMask(in)));
+                }
+                return subTail(r + i, a + i, b + i, n - i, borrow);
+            }
+
+            __attribute__((target("popcnt")))
+            size_t popcountPopcnt(const limb_t *a, size_t n) {
+                // four independent sums so that consecutive popcnt instructions do not wait on each other
+                size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    c0 += __builtin_popcountll(a[i]);
+                    c1 += __builtin_popcountll(a[i + 1]);
+                    c2 += __builtin_popcountll(a[i + 2]);
+                    c3 += __builtin_popcountll(a[i + 3]);
+                }
+                for (; i < n; i++)
+                    c0 += __builtin_popcountll(a[i]);
+                return c0 + c1 + c2 + c3;
+            }
+        }
+
+        const KernelSet AVX2_KERNELS = {"avx2", addNAvx2, subNAvx2, mul1Mulx, addMul1Mulx, popcountPopcnt};
+
+        const KernelSet ADX_KERNELS = {"adx", addNAdc, subNSbb, mul1Mulx, addMul1Adx, popcountPopcnt};
+    }
+}
+
+#endif
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include "Instrumentation.h"
+#include "divide.h"
+#include "modular.h"
+#include "multiply.h"
+
+namespace BigNum {
+    namespace kernels {
+        namespace {
+            // multiplication modulo an odd m[0..n) of values kept as x * R mod m with R = B^n
+            class MontgomeryReducer {
+            public:
+                MontgomeryReducer(const limb_t *m, size_t n) : m(m), n(n), product(makeScratch(2 * n)) {
+                    limb_t inverse = m[0];
+                    for (int i = 0; i < 5; i++)
+                        inverse *= 2 - m[0] * inverse;
+                    negInverse = 0 - inverse;
+                }
+
+                void toDomain(limb_t *r, const limb_t *a) {
+                    std::fill(product.begin(), product.begin() + n, 0);
+                    std::copy(a, a + n, product.begin() + n);
+                    auto q = makeScratch(n + 1);
+                    divRem(q.data(), r, product.data(), 2 * n, m, n);
+                }
+
+                void fromDomain(limb_t *r, const limb_t *a) {
+                    std::copy(a, a + n, product.begin());
+                    std::fill(product.begin() + n, product.end(), 0);
+                    reduce(r);
+                }
+
+                // r = a * b / R mod m, r may alias a or b
+                void mul(limb_t *r, const limb_t *a, const limb_t *b) {
+                    kernels::mul(product.data(), a, n, b, n);
+                    reduce(r);
+                }
+
+            private:
+                const limb_t *m;
+                size_t n;
+                limb_t negInverse;
+                Scratch product;
+
+                // r = product / R mod m for product < m * R; every step clears the lowest remaining limb
+                // and parks its carry there until the final addition
+                void reduce(limb_t *r) {
+                    limb_t *t = product.data();
+                    for (size_t i = 0; i < n; i++)
+                        t[i] = addMul1(t + i, m, n, t[i] * negInverse);
+                    limb_t carry = addN(r, t + n, t, n);
+                    if (carry || compare(r, m, n) >= 0)
+                        subN(r, r, m, n);
+                }
+            };
+
+            // multiplication modulo any m[0..n) using mu = B^2n / m to estimate quotients; mu takes n + 2
+            // limbs since it reaches B^(n+1) for m = B^(n-1)
+            class BarrettReducer {
+            public:
+                BarrettReducer(const limb_t *m, size_t n)
+                        : m(m), n(n), mu(makeScratch(n + 2)), product(makeScratch(2 * n)),
+                          estimate(makeScratch(2 * n + 3)), back(makeScratch(2 * n + 1)) {
+                    auto power = makeScratch(2 * n + 1);
+                    power[2 * n] = 1;
+                    auto rem = makeScratch(n);
+                    divRem(mu.data(), rem.data(), power.data(), 2 * n + 1, m, n);
+                }
+
+                void toDomain(limb_t *r, const limb_t *a) {
+                    std::copy(a, a + n, r);
+                }
+
+                void fromDomain(limb_t *r, const limb_t *a) {
+                    std::copy(a, a + n, r);
+                }
+
+                // r = a * b mod m, r may alias a or b
+                void mul(limb_t *r, const limb_t *a, const limb_t *b) {
+                    kernels::mul(product.data(), a, n, b, n);
+                    reduce(r);
+                }
+
+            private:
+                const limb_t *m;
+                size_t n;
+                Scratch mu;
+                Scratch product;
+                Scratch estimate;
+                Scratch back;
+
+                // the estimated quotient falls short by at most 2, so the remainder is fixed up by at
+                // most two subtractions; everything is computed modulo B^(n+1)
+                void reduce(limb_t *r) {
+                    kernels::mul(estimate.data(), mu.data(), n + 2, product.data() + n - 1, n + 1);
+                    kernels::mul(back.data(), estimate.data() + n + 1, n + 1, m, n);
+                    limb_t *rem = estimate.data();
+                    subN(rem, product.data(), back.data(), n + 1);
+                    while (rem[n] || compare(rem, m, n) >= 0)
+                        rem[n] -= sub(rem, rem, n, m, n);
+                    std::copy(rem, rem + n, r);
+                }
+            };
+
+            bool testBit(const limb_t *a, size_t bit) {
+                return (a[bit / LIMB_BITS] >> (bit % LIMB_BITS)) & 1;
+            }
+
+            // left-to-right scan that consumes every run of up to k bits ending in a set bit with one
+            // multiplication by a precomputed odd power
+            template<typename Reducer>
+            void slidingWindowPow(Reducer &reducer, limb_t *r, const limb_t *base, const limb_t *exp, size_t en,
+                                  size_t n) {
+                size_t bits = en * LIMB_BITS - countLeadingZeros(exp[en - 1]);
+                unsigned k = powWindowBits(bits);
+
+                // table[j] = base^(2j + 1)
+                auto table = makeScratch(n << (k - 1));
+                reducer.toDomain(table.data(), base);
+                auto square = makeScratch(n);
+                reducer.mul(square.data(), table.data(), table.data());
+                for (size_t j = 1; j < (size_t(1) << (k - 1)); j++)
+                    reducer.mul(table.data() + j * n, table.data() + (j - 1) * n, square.data());
+
+                auto acc = makeScratch(n);
+                bool started = false;
+                for (size_t i = bits; i-- > 0;) {
+                    if (!testBit(exp, i)) {
+                        reducer.mul(acc.data(), acc.data(), acc.data());
+                        continue;
+                    }
+                    size_t low = i + 1 >= k ? i + 1 - k : 0;
+                    while (!testBit(exp, low))
+                        low++;
+                    size_t window = 0;
+                    for (size_t j = i + 1; j-- > low;)
+                        window = window << 1 | testBit(exp, j);
+
+                    const limb_t *power = table.data() + (window >> 1) * n;
+                    if (started) {
+                        for (size_t j = low; j <= i; j++)
+                            reducer.mul(acc.data(), acc.data(), acc.data());
+                        reducer.mul(acc.data(), acc.data(), power);
+                    } else {
+                        std::copy(power, power + n, acc.begin());
+                        started = true;
+                    }
+                    i = low;
+                }
+                reducer.fromDomain(r, acc.data());
+            }
+        }
+
+        unsigned powWindowBits(size_t expBits) {
+            // the table costs 2^(k-1) multiplications, a window saves about bits / (k + 1) of them
+            static const size_t limits[] = {7, 25, 81, 241, 673, 1793};
+            unsigned k = 1;
+            for (size_t limit : limits) {
+                if (expBits <= limit)
+                    break;
+                k++;
+            }
+            return k;
+        }
+
+        void powMod(limb_t *r, const limb_t *base, size_t bn, const limb_t *exp, size_t en,
+                    const limb_t *m, size_t mn) {
+            auto padded = makeScratch(mn);
+            std::copy(base, base + bn, padded.begin());
+            if (m[0] & 1) {
+                BIGNUM_RECORD_ALGORITHM(PowMontgomery);
+                MontgomeryReducer reducer(m, mn);
+                slidingWindowPow(reducer, r, padded.data(), exp, en, mn);
+            } else {
+                BIGNUM_RECORD_ALGORITHM(PowBarrett);
+                BarrettReducer reducer(m, mn);
+                slidingWindowPow(reducer, r, padded.data(), exp, en, mn);
+            }
+        }
+    }
+}
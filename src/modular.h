@@ -0,0 +1,15 @@
+#pragma once
+
+#include "kernels.h"
+
+namespace BigNum {
+    namespace kernels {
+        // bits per window of the sliding-window exponent scan for an exponent of the given bit length
+        unsigned powWindowBits(size_t expBits);
+
+        // r[0..mn) = base^exp mod m for base < m (bn <= mn), en >= 1 with exp[en-1] != 0 and m[mn-1] != 0;
+        // odd moduli use Montgomery reduction, even ones Barrett reduction
+        void powMod(limb_t *r, const limb_t *base, size_t bn, const limb_t *exp, size_t en,
+                    const limb_t *m, size_t mn);
+    }
+}
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include "Instrumentation.h"
+#include "multiply.h"
+
+namespace BigNum {
+    namespace kernels {
+        namespace {
+            // signed intermediate value used by the Toom-3 evaluation and interpolation
+            struct Signed {
+                Scratch mag = makeScratch();
+                bool negative = false;
+
+                void normalize() {
+                    mag.resize(normalizedSize(mag.data(), mag.size()));
+                    if (mag.empty())
+                        negative = false;
+                }
+            };
+
+            Scratch addMagnitudes(const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+                if (an < bn) {
+                    std::swap(a, b);
+                    std::swap(an, bn);
+                }
+                auto res = makeScratch(an + 1);
+                res[an] = add(res.data(), a, an, b, bn);
+                return res;
+            }
+
+            // r = a + (negateB ? -b : b)
+            Signed addSigned(const Signed &a, const Signed &b, bool negateB = false) {
+                bool bNegative = b.negative != negateB;
+                Signed res;
+                if (a.negative == bNegative) {
+                    res.mag = addMagnitudes(a.mag.data(), a.mag.size(), b.mag.data(), b.mag.size());
+                    res.negative = a.negative;
+                } else if (compare(a.mag.data(), a.mag.size(), b.mag.data(), b.mag.size()) >= 0) {
+                    res.mag.resize(a.mag.size());
+                    sub(res.mag.data(), a.mag.data(), a.mag.size(), b.mag.data(), b.mag.size());
+                    res.negative = a.negative;
+                } else {
+                    res.mag.resize(b.mag.size());
+                    sub(res.mag.data(), b.mag.data(), b.mag.size(), a.mag.data(), a.mag.size());
+                    res.negative = bNegative;
+                }
+                res.normalize();
+                return res;
+            }
+
+            Signed multiplySigned(const Signed &a, const Signed &b) {
+                Signed res;
+                if (a.mag.empty() || b.mag.empty())
+                    return res;
+                res.mag.resize(a.mag.size() + b.mag.size());
+                if (a.mag.size() >= b.mag.size())
+                    mul(res.mag.data(), a.mag.data(), a.mag.size(), b.mag.data(), b.mag.size());
+                else
+                    mul(res.mag.data(), b.mag.data(), b.mag.size(), a.mag.data(), a.mag.size());
+                res.negative = a.negative != b.negative;
+                res.normalize();
+                return res;
+            }
+
+            Signed fromLimbs(const limb_t *a, size_t n) {
+                Signed res;
+                res.mag.assign(a, a + n);
+                res.normalize();
+                return res;
+            }
+
+            void shiftRight1(Signed &a) {
+                if (!a.mag.empty())
+                    rshift(a.mag.data(), a.mag.data(), a.mag.size(), 1);
+                a.normalize();
+            }
+
+            // r[offset..rn) += a where the sum is known to fit
+            void addInto(limb_t *r, size_t rn, size_t offset, const Scratch &a) {
+                size_t an = normalizedSize(a.data(), a.size());
+                if (an > 0)
+                    add(r + offset, r + offset, rn - offset, a.data(), an);
+            }
+
+            // a is split into chunks of bn limbs so that every partial product is balanced
+            void mulUnbalanced(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+                std::fill(r, r + an + bn, 0);
+                auto partial = makeScratch(2 * bn);
+                for (size_t offset = 0; offset < an; offset += bn) {
+                    size_t len = std::min(bn, an - offset);
+                    mul(partial.data(), b, bn, a + offset, len);
+                    add(r + offset, r + offset, an + bn - offset, partial.data(), bn + len);
+                }
+            }
+        }
+
+        void mul(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+            if (bn < KARATSUBA_THRESHOLD) {
+                BIGNUM_RECORD_ALGORITHM(MulBasecase);
+                mulBasecase(r, a, an, b, bn);
+            } else if (bn < TOOM3_THRESHOLD) {
+                BIGNUM_RECORD_ALGORITHM(MulKaratsuba);
+                mulKaratsuba(r, a, an, b, bn);
+            } else if (bn < NTT_THRESHOLD) {
+                BIGNUM_RECORD_ALGORITHM(MulToom3);
+                mulToom3(r, a, an, b, bn);
+            } else {
+                BIGNUM_RECORD_ALGORITHM(MulNtt);
+                mulNtt(r, a, an, b, bn);
+            }
+        }
+
+        // splits both operands at h limbs and uses the subtractive form
+        // a0 * b1 + a1 * b0 = a0 * b0 + a1 * b1 - (a0 - a1) * (b0 - b1)
+        void mulKaratsuba(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+            size_t h = (an + 1) / 2;
+            if (bn <= h) {
+                mulUnbalanced(r, a, an, b, bn);
+                return;
+            }
+            size_t a1n = an - h;
+            size_t b1n = bn - h;
+
+            // |a0 - a1| and |b0 - b1| with the high halves zero padded to h limbs
+            auto scratch = makeScratch(4 * h);
+            limb_t *da = scratch.data();
+            limb_t *db = da + h;
+            limb_t *middle = db + h;
+            std::copy(a + h, a + an, da);
+            std::copy(b + h, b + bn, db);
+            bool aNegative = compare(a, da, h) < 0;
+            if (aNegative)
+                subN(da, da, a, h);
+            else
+                subN(da, a, da, h);
+            bool bNegative = compare(b, db, h) < 0;
+            if (bNegative)
+                subN(db, db, b, h);
+            else
+                subN(db, b, db, h);
+
+            mul(r, a, h, b, h);
+            mul(r + 2 * h, a + h, a1n, b + h, b1n);
+            mul(middle, da, h, db, h);
+
+            // middle = z0 + z2 -+ |a0 - a1| * |b0 - b1|
+            Scratch sum = addMagnitudes(r, 2 * h, r + 2 * h, a1n + b1n);
+            if (aNegative == bNegative)
+                sub(sum.data(), sum.data(), sum.size(), middle, 2 * h);
+            else
+                add(sum.data(), sum.data(), sum.size(), middle, 2 * h);
+            addInto(r, an + bn, h, sum);
+        }
+
+        // evaluates at 0, 1, -1, 2 and infinity and interpolates with Bodrato's sequence
+        void mulToom3(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+            size_t k = (an + 2) / 3;
+            if (bn <= 2 * k) {
+                if (bn < (an + 1) / 2 + 1)
+                    mulUnbalanced(r, a, an, b, bn);
+                else
+                    mulKaratsuba(r, a, an, b, bn);
+                return;
+            }
+
+            Signed a0 = fromLimbs(a, k), a1 = fromLimbs(a + k, k), a2 = fromLimbs(a + 2 * k, an - 2 * k);
+            Signed b0 = fromLimbs(b, k), b1 = fromLimbs(b + k, k), b2 = fromLimbs(b + 2 * k, bn - 2 * k);
+
+            Signed a02 = addSigned(a0, a2), b02 = addSigned(b0, b2);
+            Signed ap1 = addSigned(a02, a1), bp1 = addSigned(b02, b1);
+            Signed am1 = addSigned(a02, a1, true), bm1 = addSigned(b02, b1, true);
+            // p(2) = a0 + 2 * (a1 + 2 * a2)
+            Signed ap2 = addSigned(addSigned(a1, a2), a2), bp2 = addSigned(addSigned(b1, b2), b2);
+            ap2 = addSigned(a0, addSigned(ap2, ap2));
+            bp2 = addSigned(b0, addSigned(bp2, bp2));
+            a02 = {};
+            b02 = {};
+
+            Signed r0 = multiplySigned(a0, b0);
+            Signed r1 = multiplySigned(ap1, bp1);
+            Signed rm1 = multiplySigned(am1, bm1);
+            Signed r2 = multiplySigned(ap2, bp2);
+            Signed rInf = multiplySigned(a2, b2);
+
+            Signed t = addSigned(r2, rm1, true);
+            if (!t.mag.empty())
+                divExact1(t.mag.data(), t.mag.data(), t.mag.size(), 3);
+            t.normalize();
+            Signed u = addSigned(r1, rm1, true);
+            shiftRight1(u);
+            Signed v = addSigned(rm1, r0, true);
+            t = addSigned(t, v, true);
+            shiftRight1(t);
+            t = addSigned(t, addSigned(rInf, rInf), true);
+            v = addSigned(addSigned(v, u), rInf, true);
+            t = addSigned(t, u, true);
+            u = addSigned(u, t, true);
+
+            // all coefficients of the product are non-negative now
+            std::fill(r, r + an + bn, 0);
+            std::copy(r0.mag.begin(), r0.mag.end(), r);
+            addInto(r, an + bn, k, u.mag);
+            addInto(r, an + bn, 2 * k, v.mag);
+            addInto(r, an + bn, 3 * k, t.mag);
+            addInto(r, an + bn, 4 * k, rInf.mag);
+        }
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "kernels.h"
+
+namespace BigNum {
+    namespace kernels {
+        // operand sizes (in limbs of the shorter operand) at which the next algorithm takes over
+        constexpr size_t KARATSUBA_THRESHOLD = 32;
+        constexpr size_t TOOM3_THRESHOLD = 256;
+        constexpr size_t NTT_THRESHOLD = 3000;
+
+        // r[0..an+bn) = a * b for an >= bn >= 1, picking the algorithm from the operand sizes;
+        // r must not overlap inputs
+        void mul(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn);
+
+        void mulKaratsuba(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn);
+
+        void mulToom3(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn);
+
+        void mulNtt(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn);
+    }
+}
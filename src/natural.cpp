@@ -0,0 +1,93 @@
+#include <algorithm>
+#include "divide.h"
+#include "multiply.h"
+#include "natural.h"
+
+namespace BigNum {
+    namespace kernels {
+        void normalize(Natural &a) {
+            a.resize(normalizedSize(a.data(), a.size()));
+        }
+
+        Natural fromLimb(limb_t a) {
+            auto res = makeScratch();
+            if (a)
+                res.push_back(a);
+            return res;
+        }
+
+        int compare(const Natural &a, const Natural &b) {
+            return compare(a.data(), a.size(), b.data(), b.size());
+        }
+
+        size_t bitLength(const Natural &a) {
+            return a.empty() ? 0 : a.size() * LIMB_BITS - countLeadingZeros(a.back());
+        }
+
+        Natural product(const Natural &a, const Natural &b) {
+            auto res = makeScratch();
+            if (a.empty() || b.empty())
+                return res;
+            res.resize(a.size() + b.size());
+            if (a.size() >= b.size())
+                mul(res.data(), a.data(), a.size(), b.data(), b.size());
+            else
+                mul(res.data(), b.data(), b.size(), a.data(), a.size());
+            normalize(res);
+            return res;
+        }
+
+        Natural sum(const Natural &a, const Natural &b) {
+            const Natural &longer = a.size() >= b.size() ? a : b;
+            const Natural &shorter = a.size() >= b.size() ? b : a;
+            auto res = makeScratch(longer.size() + 1);
+            res.back() = add(res.data(), longer.data(), longer.size(), shorter.data(), shorter.size());
+            normalize(res);
+            return res;
+        }
+
+        Natural difference(const Natural &a, const Natural &b) {
+            auto res = makeScratch(a.size());
+            sub(res.data(), a.data(), a.size(), b.data(), b.size());
+            normalize(res);
+            return res;
+        }
+
+        Natural shiftedLeft(const Natural &a, size_t bits) {
+            if (a.empty())
+                return makeScratch();
+            size_t limbShift = bits / LIMB_BITS;
+            auto res = makeScratch(a.size() + limbShift + 1);
+            if (bits % LIMB_BITS)
+                res.back() = lshift(res.data() + limbShift, a.data(), a.size(), bits % LIMB_BITS);
+            else
+                std::copy(a.begin(), a.end(), res.begin() + limbShift);
+            normalize(res);
+            return res;
+        }
+
+        Natural shiftedRight(const Natural &a, size_t bits) {
+            size_t limbShift = bits / LIMB_BITS;
+            if (limbShift >= a.size())
+                return makeScratch();
+            auto res = makeScratch(a.data() + limbShift, a.data() + a.size());
+            if (bits % LIMB_BITS)
+                rshift(res.data(), res.data(), res.size(), bits % LIMB_BITS);
+            normalize(res);
+            return res;
+        }
+
+        void divRemNatural(const Natural &a, const Natural &b, Natural &q, Natural &r) {
+            if (compare(a, b) < 0) {
+                q.clear();
+                r = a;
+                return;
+            }
+            q.assign(a.size() - b.size() + 1, 0);
+            r.assign(b.size(), 0);
+            divRem(q.data(), r.data(), a.data(), a.size(), b.data(), b.size());
+            normalize(q);
+            normalize(r);
+        }
+    }
+}
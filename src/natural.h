@@ -0,0 +1,33 @@
+#pragma once
+
+#include "kernels.h"
+
+namespace BigNum {
+    namespace kernels {
+        // non-negative value without most significant zero limbs, for the algorithms that juggle many
+        // intermediate numbers of changing size
+        using Natural = Scratch;
+
+        void normalize(Natural &a);
+
+        Natural fromLimb(limb_t a);
+
+        int compare(const Natural &a, const Natural &b);
+
+        size_t bitLength(const Natural &a);
+
+        Natural product(const Natural &a, const Natural &b);
+
+        Natural sum(const Natural &a, const Natural &b);
+
+        // a - b for a >= b
+        Natural difference(const Natural &a, const Natural &b);
+
+        Natural shiftedLeft(const Natural &a, size_t bits);
+
+        Natural shiftedRight(const Natural &a, size_t bits);
+
+        // q = a / b and r = a % b for b != 0
+        void divRemNatural(const Natural &a, const Natural &b, Natural &q, Natural &r);
+    }
+}
@@ -0,0 +1,286 @@
+#include <algorithm>
+#include "ExecutionPolicy.h"
+#include "multiply.h"
+
+namespace BigNum {
+    namespace kernels {
+        namespace {
+            // arithmetic modulo an NTT prime p < 2^62 with values kept in Montgomery form (R = 2^64)
+            struct Modulus {
+                limb_t p;
+                limb_t root; // primitive root modulo p
+                limb_t negInverse; // -p^-1 mod 2^64
+                limb_t r2; // R^2 mod p
+
+                Modulus(limb_t p, limb_t root) : p(p), root(root) {
+                    limb_t inverse = p;
+                    for (int i = 0; i < 5; i++)
+                        inverse *= 2 - p * inverse;
+                    negInverse = 0 - inverse;
+                    limb_t r = (limb_t) (((dlimb_t) 1 << LIMB_BITS) % p);
+                    r2 = (limb_t) ((dlimb_t) r * r % p);
+                }
+
+                // a * b / R mod p, valid whenever a * b < 2^64 * p
+                limb_t mul(limb_t a, limb_t b) const {
+                    dlimb_t t = (dlimb_t) a * b;
+                    limb_t m = (limb_t) t * negInverse;
+                    limb_t u = (limb_t) ((t + (dlimb_t) m * p) >> LIMB_BITS);
+                    return u >= p ? u - p : u;
+                }
+
+                limb_t add(limb_t a, limb_t b) const {
+                    limb_t s = a + b;
+                    return s >= p ? s - p : s;
+                }
+
+                limb_t sub(limb_t a, limb_t b) const {
+                    return a >= b ? a - b : a + p - b;
+                }
+
+                limb_t toMontgomery(limb_t a) const {
+                    return mul(a, r2);
+                }
+
+                // base and result in Montgomery form
+                limb_t pow(limb_t base, uint64_t exp) const {
+                    limb_t res = toMontgomery(1);
+                    for (; exp; exp >>= 1) {
+                        if (exp & 1)
+                            res = mul(res, base);
+                        base = mul(base, base);
+                    }
+                    return res;
+                }
+
+                // normal form inverse of a normal form value
+                limb_t inverse(limb_t a) const {
+                    return mul(pow(toMontgomery(a), p - 2), 1);
+                }
+            };
+
+            // three primes of the form c * 2^41 + 1 whose product exceeds every convolution coefficient
+            const Modulus PRIMES[3] = {
+                    {4611615649683210241ull, 11},
+                    {4611613450659954689ull, 3},
+                    {4611549678985543681ull, 19},
+            };
+            constexpr unsigned MAX_LOG_LENGTH = 41;
+
+            // powers w^0 .. w^(n/2 - 1) of a primitive n-th root of unity (or of its inverse)
+            Scratch twiddles(const Modulus &mod, size_t n, bool inverse, bool parallel) {
+                limb_t w = mod.pow(mod.toMontgomery(mod.root), (mod.p - 1) / n);
+                if (inverse)
+                    w = mod.pow(w, n - 1);
+                auto res = makeScratch(n / 2);
+                parallelRanges(n / 2, parallel, [&](size_t begin, size_t end) {
+                    limb_t cur = mod.pow(w, begin);
+                    for (size_t i = begin; i < end; i++) {
+                        res[i] = cur;
+                        cur = mod.mul(cur, w);
+                    }
+                });
+                return res;
+            }
+
+            // butterflies of the stages of length size down to 2 on one block of size values
+            void forwardStages(const Modulus &mod, limb_t *a, size_t size, size_t n, const Scratch &w) {
+                for (size_t len = size; len >= 2; len >>= 1) {
+                    size_t half = len / 2;
+                    size_t step = n / len;
+                    for (size_t i = 0; i < size; i += len) {
+                        for (size_t j = 0; j < half; j++) {
+                            limb_t u = a[i + j];
+                            limb_t v = a[i + j + half];
+                            a[i + j] = mod.add(u, v);
+                            a[i + j + half] = mod.mul(mod.sub(u, v), w[j * step]);
+                        }
+                    }
+                }
+            }
+
+            // butterflies of the stages of length 2 up to size on one block of size values
+            void backwardStages(const Modulus &mod, limb_t *a, size_t size, size_t n, const Scratch &w) {
+                for (size_t len = 2; len <= size; len <<= 1) {
+                    size_t half = len / 2;
+                    size_t step = n / len;
+                    for (size_t i = 0; i < size; i += len) {
+                        for (size_t j = 0; j < half; j++) {
+                            limb_t u = a[i + j];
+                            limb_t v = mod.mul(a[i + j + half], w[j * step]);
+                            a[i + j] = mod.add(u, v);
+                            a[i + j + half] = mod.sub(u, v);
+                        }
+                    }
+                }
+            }
+
+            // block length from which the stages of a parallel transform run block by block, each block
+            // on one thread; the longer stages split their butterflies over the threads instead
+            size_t parallelBlock(size_t n) {
+                size_t blocks = 4 * size_t(currentExecutionPolicy().threads);
+                size_t size = n;
+                while (size > 2 && n / size < blocks)
+                    size >>= 1;
+                return size;
+            }
+
+            // decimation in frequency, natural order in, bit-reversed order out
+            void forward(const Modulus &mod, limb_t *a, size_t n, const Scratch &w, bool parallel) {
+                if (!parallel) {
+                    forwardStages(mod, a, n, n, w);
+                    return;
+                }
+
+                size_t block = parallelBlock(n);
+                for (size_t len = n; len > block; len >>= 1) {
+                    size_t half = len / 2;
+                    size_t step = n / len;
+                    // butterfly k pairs a[2k - j] and a[2k - j + half] for j = k mod half
+                    parallelRanges(n / 2, true, [&](size_t begin, size_t end) {
+                        for (size_t k = begin; k < end; k++) {
+                            size_t j = k & (half - 1);
+                            limb_t *x = a + 2 * k - j;
+                            limb_t u = x[0];
+                            limb_t v = x[half];
+                            x[0] = mod.add(u, v);
+                            x[half] = mod.mul(mod.sub(u, v), w[j * step]);
+                        }
+                    });
+                }
+                parallelFor(n / block, [&](size_t i) {
+                    forwardStages(mod, a + i * block, block, n, w);
+                });
+            }
+
+            // decimation in time, bit-reversed order in, natural order out, without the 1/n scaling
+            void backward(const Modulus &mod, limb_t *a, size_t n, const Scratch &w, bool parallel) {
+                if (!parallel) {
+                    backwardStages(mod, a, n, n, w);
+                    return;
+                }
+
+                size_t block = parallelBlock(n);
+                parallelFor(n / block, [&](size_t i) {
+                    backwardStages(mod, a + i * block, block, n, w);
+                });
+                for (size_t len = 2 * block; len <= n; len <<= 1) {
+                    size_t half = len / 2;
+                    size_t step = n / len;
+                    parallelRanges(n / 2, true, [&](size_t begin, size_t end) {
+                        for (size_t k = begin; k < end; k++) {
+                            size_t j = k & (half - 1);
+                            limb_t *x = a + 2 * k - j;
+                            limb_t u = x[0];
+                            limb_t v = mod.mul(x[half], w[j * step]);
+                            x[0] = mod.add(u, v);
+                            x[half] = mod.sub(u, v);
+                        }
+                    });
+                }
+            }
+
+            // cyclic convolution of a and b modulo one prime, written in normal form to res[0..n)
+            void convolve(const Modulus &mod, limb_t *res, size_t n, const limb_t *a, size_t an,
+                          const limb_t *b, size_t bn, bool parallel) {
+                auto fa = makeScratch(n);
+                parallelRanges(an, parallel, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++)
+                        fa[i] = mod.toMontgomery(a[i]);
+                });
+                auto w = twiddles(mod, n, false, parallel);
+                forward(mod, fa.data(), n, w, parallel);
+
+                bool square = a == b && an == bn;
+                auto fb = makeScratch();
+                if (!square) {
+                    fb.resize(n);
+                    parallelRanges(bn, parallel, [&](size_t begin, size_t end) {
+                        for (size_t i = begin; i < end; i++)
+                            fb[i] = mod.toMontgomery(b[i]);
+                    });
+                    forward(mod, fb.data(), n, w, parallel);
+                }
+                const limb_t *other = square ? fa.data() : fb.data();
+                parallelRanges(n, parallel, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++)
+                        res[i] = mod.mul(fa[i], other[i]);
+                });
+
+                backward(mod, res, n, twiddles(mod, n, true, parallel), parallel);
+                limb_t scale = mod.inverse(n % mod.p);
+                parallelRanges(n, parallel, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++)
+                        res[i] = mod.mul(res[i], scale);
+                });
+            }
+        }
+
+        // three-prime number theoretic transform over full 64-bit coefficients, recombined with Garner's CRT
+        void mulNtt(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+            size_t rn = an + bn;
+            size_t n = 1;
+            while (n < rn - 1)
+                n <<= 1;
+            if (n > (size_t(1) << MAX_LOG_LENGTH)) {
+                mulToom3(r, a, an, b, bn);
+                return;
+            }
+
+            // every stage of the transforms and the recombination is split over threads under a parallel policy
+            bool parallel = runParallel(bn);
+            Scratch residues[3] = {makeScratch(n), makeScratch(n), makeScratch(n)};
+            for (int i = 0; i < 3; i++) {
+                convolve(PRIMES[i], residues[i].data(), n, a, an, b, bn, parallel);
+            }
+
+            const Modulus &m1 = PRIMES[0], &m2 = PRIMES[1], &m3 = PRIMES[2];
+            // Montgomery form constants make mul(x, c) return x * constant in normal form
+            static const limb_t inverse12 = m2.toMontgomery(m2.inverse(m1.p % m2.p));
+            static const limb_t p1Mod3 = m3.toMontgomery(m1.p % m3.p);
+            static const limb_t inverse123 = m3.toMontgomery(
+                    m3.inverse((limb_t) ((dlimb_t) m1.p * m2.p % m3.p)));
+            static const dlimb_t p12 = (dlimb_t) m1.p * m2.p;
+
+            // coefficient i as three limbs in place of its residues, independently of the others
+            parallelRanges(rn - 1, parallel, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    limb_t r1 = residues[0][i], r2 = residues[1][i], r3 = residues[2][i];
+                    limb_t y2 = m2.mul(m2.sub(r2, r1 >= m2.p ? r1 - m2.p : r1), inverse12);
+                    limb_t x12Mod3 = m3.add(r1 >= m3.p ? r1 - m3.p : r1, m3.mul(y2, p1Mod3));
+                    limb_t y3 = m3.mul(m3.sub(r3, x12Mod3), inverse123);
+
+                    // x = r1 + p1 * y2 + p1 * p2 * y3
+                    dlimb_t x12 = (dlimb_t) m1.p * y2 + r1;
+                    dlimb_t low = (dlimb_t) (limb_t) p12 * y3;
+                    dlimb_t high = (dlimb_t) (limb_t) (p12 >> LIMB_BITS) * y3 + (limb_t) (low >> LIMB_BITS);
+                    limb_t x0 = (limb_t) low, x1 = (limb_t) high, x2 = (limb_t) (high >> LIMB_BITS);
+                    dlimb_t s = (dlimb_t) x0 + (limb_t) x12;
+                    x0 = (limb_t) s;
+                    s = (dlimb_t) x1 + (limb_t) (x12 >> LIMB_BITS) + (limb_t) (s >> LIMB_BITS);
+                    x1 = (limb_t) s;
+                    x2 += (limb_t) (s >> LIMB_BITS);
+                    residues[0][i] = x0;
+                    residues[1][i] = x1;
+                    residues[2][i] = x2;
+                }
+            });
+
+            // running 192-bit accumulator of the coefficients shifted into place
+            limb_t acc0 = 0, acc1 = 0, acc2 = 0;
+            for (size_t i = 0; i < rn; i++) {
+                if (i < rn - 1) {
+                    dlimb_t s = (dlimb_t) acc0 + residues[0][i];
+                    acc0 = (limb_t) s;
+                    s = (dlimb_t) acc1 + residues[1][i] + (limb_t) (s >> LIMB_BITS);
+                    acc1 = (limb_t) s;
+                    acc2 += residues[2][i] + (limb_t) (s >> LIMB_BITS);
+                }
+                r[i] = acc0;
+                acc0 = acc1;
+                acc1 = acc2;
+                acc2 = 0;
+            }
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#include "primes.h"
+
+namespace BigNum {
+    namespace kernels {
+        std::vector<uint64_t> primesUpTo(uint64_t n) {
+            std::vector<uint64_t> res;
+            if (n < 2)
+                return res;
+            res.push_back(2);
+
+            // composite[i] stands for the odd number 2 * i + 1
+            std::vector<bool> composite(n / 2 + 1);
+            for (uint64_t i = 1; 2 * i + 1 <= n; i++) {
+                if (composite[i])
+                    continue;
+                uint64_t p = 2 * i + 1;
+                res.push_back(p);
+                for (uint64_t j = p * p / 2; p <= n / p && j <= n / 2; j += p)
+                    composite[j] = true;
+            }
+            return res;
+        }
+    }
+}
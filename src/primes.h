@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace BigNum {
+    namespace kernels {
+        // all primes p <= n in increasing order, by a sieve of Eratosthenes over the odd numbers
+        std::vector<uint64_t> primesUpTo(uint64_t n);
+    }
+}
@@ -0,0 +1,242 @@
+#include <cmath>
+#include "natural.h"
+#include "roots.h"
+
+namespace BigNum {
+    namespace kernels {
+        namespace {
+            // r^k, or the largest value if that overflows
+            dlimb_t saturatedPower(dlimb_t r, unsigned k) {
+                dlimb_t res = 1;
+                for (unsigned i = 0; i < k; i++) {
+                    if (__builtin_mul_overflow(res, r, &res))
+                        return ~(dlimb_t) 0;
+                }
+                return res;
+            }
+
+            // a double carries the root of values of up to this many bits to within a unit
+            constexpr size_t WIDE_ROOT_BITS = 100;
+
+            // floating-point estimate fixed up to the exact root, for k >= 2
+            limb_t rootWide(dlimb_t a, unsigned k) {
+                auto r = (dlimb_t) std::pow((double) a, 1.0 / k);
+                while (r > 0 && saturatedPower(r, k) > a)
+                    r--;
+                while (saturatedPower(r + 1, k) <= a)
+                    r++;
+                return (limb_t) r;
+            }
+
+            Natural power(const Natural &x, unsigned k) {
+                Natural res = fromLimb(1), base = x;
+                for (; k; k >>= 1) {
+                    if (k & 1)
+                        res = product(res, base);
+                    if (k > 1)
+                        base = product(base, base);
+                }
+                return res;
+            }
+
+            // ((k - 1) * x + a / x^(k - 1)) / k, the Newton step for x^k = a
+            Natural newtonStep(const Natural &a, const Natural &x, unsigned k) {
+                auto quotient = makeScratch(), rem = makeScratch();
+                divRemNatural(a, power(x, k - 1), quotient, rem);
+                Natural res = sum(product(x, fromLimb(k - 1)), quotient);
+                divRem1(res.data(), res.data(), res.size(), k);
+                normalize(res);
+                return res;
+            }
+
+            Natural rootNatural(const Natural &a, unsigned k) {
+                size_t bits = bitLength(a);
+                if (bits <= WIDE_ROOT_BITS) {
+                    dlimb_t wide = a.empty() ? 0 : a[0] | (a.size() > 1 ? (dlimb_t) a[1] << LIMB_BITS : 0);
+                    return fromLimb(rootWide(wide, k));
+                }
+                // 2^k > a leaves only 1 as the root
+                if (k >= bits)
+                    return fromLimb(1);
+
+                // the root of the number without its low k * shift bits gives the leading half of the
+                // root's bits, and (top + 1) * 2^shift is above the root; Newton's method falls from there
+                // and stops at the first step that does not decrease
+                size_t shift = (bits / k + 1) / 2;
+                Natural top = rootNatural(shiftedRight(a, k * shift), k);
+                Natural x = shiftedLeft(sum(top, fromLimb(1)), shift);
+                while (true) {
+                    Natural next = newtonStep(a, x, k);
+                    if (compare(next, x) >= 0)
+                        return x;
+                    x = std::move(next);
+                }
+            }
+
+            limb_t remWord(const limb_t *a, size_t n, limb_t m) {
+                limb_t rem = 0;
+                while (n-- > 0)
+                    rem = (limb_t) ((((dlimb_t) rem << LIMB_BITS) | a[n]) % m);
+                return rem;
+            }
+
+            // bit i of RESIDUES_MOD_m is set when i is a square modulo m
+            bool isResidue(const uint64_t *residues, limb_t value) {
+                return (residues[value / 64] >> (value % 64)) & 1;
+            }
+
+            limb_t mulMod(limb_t a, limb_t b, limb_t m) {
+                return (limb_t) ((dlimb_t) a * b % m);
+            }
+
+            limb_t powMod(limb_t base, limb_t exp, limb_t m) {
+                limb_t res = 1 % m;
+                for (base %= m; exp; exp >>= 1) {
+                    if (exp & 1)
+                        res = mulMod(res, base, m);
+                    base = mulMod(base, base, m);
+                }
+                return res;
+            }
+
+            // for odd q
+            bool isSmallPrime(limb_t q) {
+                if (q < 3)
+                    return false;
+                for (limb_t d = 3; d * d <= q; d += 2) {
+                    if (q % d == 0)
+                        return false;
+                }
+                return true;
+            }
+
+            // primes q = 1 (mod p) against which residuesAllowPower checks
+            constexpr size_t POWER_RESIDUE_MODULI = 4;
+
+            // whether a could be a p-th power judging by its residues modulo primes q = 1 (mod p): only 1 in p
+            // of the non-zero residues modulo such a q is a p-th power, and those are the x with
+            // x^((q - 1) / p) = 1. Moduli are multiplied together while they fit in a limb, so most exponents
+            // take a single pass over a
+            bool residuesAllowPower(const limb_t *a, size_t n, unsigned p) {
+                limb_t moduli[POWER_RESIDUE_MODULI];
+                size_t count = 0;
+                for (limb_t q = 2 * (limb_t) p + 1; count < POWER_RESIDUE_MODULI; q += 2 * (limb_t) p) {
+                    if (isSmallPrime(q))
+                        moduli[count++] = q;
+                }
+
+                for (size_t first = 0; first < count;) {
+                    limb_t product = moduli[first];
+                    size_t last = first + 1;
+                    for (limb_t next; last < count && !__builtin_mul_overflow(product, moduli[last], &next); last++)
+                        product = next;
+
+                    limb_t rem = remWord(a, n, product);
+                    for (size_t i = first; i < last; i++) {
+                        limb_t q = moduli[i], x = rem % q;
+                        if (x != 0 && powMod(x, (q - 1) / p, q) != 1)
+                            return false;
+                    }
+                    first = last;
+                }
+                return true;
+            }
+
+            // 2^61 - 1, the prime modulo which candidate roots from a floating-point estimate are checked
+            constexpr limb_t MERSENNE_61 = ((limb_t) 1 << 61) - 1;
+
+            // roots of at most this many bits are pinned down by a floating-point estimate of a's logarithm
+            constexpr size_t ESTIMATED_ROOT_BITS = 32;
+
+            // the integer nearest to a^(1/p) from the leading bits of the normalized a[0..n)
+            limb_t estimateRoot(const limb_t *a, size_t n, unsigned p) {
+                long double top = (long double) a[n - 1];
+                long double log2a = (long double) (LIMB_BITS * (n - 1));
+                if (n > 1) {
+                    top = std::ldexp(top, LIMB_BITS) + (long double) a[n - 2];
+                    log2a -= LIMB_BITS;
+                }
+                log2a += std::log2(top);
+                return (limb_t) std::llround(std::exp2(log2a / p));
+            }
+
+            struct ResidueTable {
+                limb_t modulus;
+                uint64_t residues[2];
+
+                explicit ResidueTable(limb_t modulus) : modulus(modulus), residues() {
+                    for (limb_t i = 0; i < modulus; i++)
+                        residues[i * i % modulus / 64] |= uint64_t(1) << (i * i % modulus % 64);
+                }
+            };
+        }
+
+        Scratch root(const limb_t *a, size_t n, unsigned k) {
+            Natural value = makeScratch(a, a + n);
+            if (k == 1 || value.empty())
+                return value;
+            return rootNatural(value, k);
+        }
+
+        bool isSquare(const limb_t *a, size_t n) {
+            if (n == 0)
+                return true;
+            // squares modulo 64, 63, 65 and 11 together let through about 1 in 100 non-squares
+            static const ResidueTable tables[] = {ResidueTable(64), ResidueTable(63), ResidueTable(65),
+                                                  ResidueTable(11)};
+            if (!isResidue(tables[0].residues, a[0] % 64))
+                return false;
+            limb_t rem = remWord(a, n, 63 * 65 * 11);
+            for (size_t i = 1; i < 4; i++) {
+                if (!isResidue(tables[i].residues, rem % tables[i].modulus))
+                    return false;
+            }
+
+            Natural value = makeScratch(a, a + n);
+            Natural r = rootNatural(value, 2);
+            return compare(product(r, r), value) == 0;
+        }
+
+        bool isPower(const limb_t *a, size_t n, bool oddOnly) {
+            Natural value = makeScratch(a, a + n);
+            size_t bits = bitLength(value);
+            if (bits <= 1)
+                return true;
+            if (!oddOnly && isSquare(a, n))
+                return true;
+
+            // b^p has a multiple of p trailing zero bits
+            size_t zeros = 0;
+            while (a[zeros / LIMB_BITS] == 0)
+                zeros += LIMB_BITS;
+            zeros += countTrailingZeros(a[zeros / LIMB_BITS]);
+
+            // it is enough to try prime exponents, and 2^p > a rules out p >= bits. Each exponent is first
+            // screened without computing the root: a small root is estimated from the leading bits and its
+            // power compared modulo 2^61 - 1, a large one has to pass the power residue tests. Only the
+            // exponents that pass get the exact root
+            limb_t aMod61 = remWord(a, n, MERSENNE_61);
+            for (unsigned p = 3; p < bits; p += 2) {
+                bool prime = true;
+                for (unsigned d = 3; d * d <= p && prime; d += 2)
+                    prime = p % d != 0;
+                if (!prime || (zeros && zeros % p))
+                    continue;
+
+                if (bits <= ESTIMATED_ROOT_BITS * p) {
+                    // the estimate is within a small fraction of a unit, so the root is one of its neighbours
+                    limb_t estimate = estimateRoot(a, n, p);
+                    for (limb_t r = estimate > 1 ? estimate - 1 : 1; r <= estimate + 1; r++) {
+                        if (powMod(r, p, MERSENNE_61) == aMod61 &&
+                            compare(power(fromLimb(r), p), value) == 0)
+                            return true;
+                    }
+                    continue;
+                }
+                if (residuesAllowPower(a, n, p) && compare(power(rootNatural(value, p), p), value) == 0)
+                    return true;
+            }
+            return false;
+        }
+    }
+}
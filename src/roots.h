@@ -0,0 +1,16 @@
+#pragma once
+
+#include "kernels.h"
+
+namespace BigNum {
+    namespace kernels {
+        // floor(a^(1/k)) of the normalized a[0..n) for k >= 1; the result is normalized
+        Scratch root(const limb_t *a, size_t n, unsigned k);
+
+        // whether the normalized a[0..n) is the square of an integer
+        bool isSquare(const limb_t *a, size_t n);
+
+        // whether the normalized a[0..n) is b^k for some k >= 2, with odd k only if oddOnly
+        bool isPower(const limb_t *a, size_t n, bool oddOnly);
+    }
+}
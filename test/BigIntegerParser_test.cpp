@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include "../src/BigIntegerParser.h"
+
+using namespace BigNum;
+
+TEST(BigIntegerParser, ChunksMatchWholeParse) {
+    std::string digits;
+    for (int i = 0; i < 3000; i++)
+        digits.push_back(static_cast<char>('0' + (i * 7 + i / 13) % 10));
+    std::string text = "  -" + digits + ",next";
+    BigInteger expected("-" + digits);
+
+    for (size_t chunkSize : {1, 7, 19, 64, 4096}) {
+        BigIntegerParser parser;
+        size_t pos = 0;
+        while (!parser.done() && pos < text.size()) {
+            std::string_view chunk = std::string_view(text).substr(pos, chunkSize);
+            pos += static_cast<size_t>(parser.feed(chunk) - chunk.data());
+        }
+        ASSERT_TRUE(parser.done());
+        ASSERT_EQ(text[pos], ',');
+        BigInteger value;
+        ASSERT_EQ(parser.finish(value), std::errc());
+        ASSERT_EQ(value, expected);
+    }
+
+    BigIntegerParser parser;
+    BigInteger value(3);
+    parser.feed("000");
+    parser.feed("0120");
+    ASSERT_FALSE(parser.done());
+    ASSERT_EQ(parser.finish(value), std::errc());
+    ASSERT_EQ(value, BigInteger(120));
+
+    parser.feed(" -");
+    ASSERT_EQ(parser.finish(value), std::errc::invalid_argument);
+    ASSERT_EQ(value, BigInteger(120));
+    parser.feed("-0");
+    ASSERT_EQ(parser.finish(value), std::errc());
+    ASSERT_EQ(value, BigInteger(0));
+}
+
+TEST(BigIntegerParser, StreamInput) {
+    std::istringstream in(" 12345678901234567890123 -17\nabc");
+    BigInteger a, b, c;
+    in >> a >> b;
+    ASSERT_TRUE(in);
+    ASSERT_EQ(a, BigInteger("12345678901234567890123"));
+    ASSERT_EQ(b, BigInteger(-17));
+    in >> c;
+    ASSERT_TRUE(in.fail());
+
+    std::istringstream last("99");
+    last >> a;
+    ASSERT_FALSE(last.fail());
+    ASSERT_TRUE(last.eof());
+    ASSERT_EQ(a, BigInteger(99));
+}
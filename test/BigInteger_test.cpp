@@ -1,9 +1,53 @@
 #include <gtest/gtest.h>
+#include <climits>
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <vector>
 #include "../src/BigInteger.h"
+#include "../src/BigIntegerParser.h"
 
 using namespace BigNum;
 
+namespace {
+    // heap allocations of the calling thread, counted by the replaced global operator new below
+    thread_local size_t heapAllocations = 0;
+}
+
+void *operator new(std::size_t size) {
+    heapAllocations++;
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+// std::pmr::new_delete_resource, which backs the limb buffers, allocates through the aligned forms
+void *operator new(std::size_t size, std::align_val_t align) {
+    heapAllocations++;
+    auto alignment = static_cast<std::size_t>(align);
+    if (void *ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
 TEST(BigInteger, DefaultConstructor) {
     BigInteger bi;
     ASSERT_EQ(0, bi.value<int>());
@@ -225,4 +269,618 @@ TEST(BigInteger, negate) {
 
     bi = -BigInteger(-4906);
     ASSERT_EQ(bi, 4906);
-}
\ No newline at end of file
+}
+
+TEST(BigInteger, MultiLimb) {
+    BigInteger a("3345464456576867887943425467865434247657999354657687987987654235345");
+    BigInteger b("123346576786546566787654356576876865");
+    ASSERT_EQ(a.toString(), "3345464456576867887943425467865434247657999354657687987987654235345");
+    ASSERT_EQ((a * b).toString(),
+              "412651588479820917412834419465837335682402027042950288493602813246739710440267302619814046809795793425");
+    ASSERT_EQ((-a * b).toString(),
+              "-412651588479820917412834419465837335682402027042950288493602813246739710440267302619814046809795793425");
+    ASSERT_EQ(a % b, BigInteger("113978074707290686072881367367147970"));
+    ASSERT_EQ((a * b + 17) / b, a);
+    ASSERT_EQ(a * b - a * b, 0);
+    ASSERT_EQ(BigInteger("18446744073709551615") * BigInteger("18446744073709551615"),
+              BigInteger("340282366920938463426481119284349108225"));
+    ASSERT_EQ(BigInteger("340282366920938463463374607431768211456") - 1,
+              BigInteger("340282366920938463463374607431768211455"));
+    ASSERT_EQ(BigInteger("-0"), BigInteger());
+    ASSERT_EQ(-BigInteger(), BigInteger());
+    ASSERT_THROW({ BigInteger("-"); }, std::invalid_argument);
+}
+
+namespace {
+    // deterministic pseudo-random number with about the given count of 64-bit limbs
+    BigInteger makeLarge(size_t limbs, uint64_t seed) {
+        BigInteger res(1);
+        uint64_t state = seed;
+        for (size_t i = 0; i < limbs; i++) {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            res = res * BigInteger::from<uint64_t>(state | 1) + static_cast<int64_t>(state >> 1);
+        }
+        return res;
+    }
+}
+
+TEST(BigInteger, MultiplyLarge) {
+    for (size_t size : {20, 50, 120, 400, 900}) {
+        auto a = makeLarge(size, 1);
+        auto b = makeLarge(size * 2 / 3, 2);
+        auto c = makeLarge(size + 7, 3);
+        ASSERT_EQ(a * (b + c), a * b + a * c);
+        ASSERT_EQ(b * c, c * b);
+        ASSERT_EQ((a * c) / c, a);
+        ASSERT_EQ((-a * c) % c, 0);
+    }
+
+    BigInteger tenPower("1" + std::string(6000, '0'));
+    ASSERT_EQ((tenPower - 1) * (tenPower + 1), tenPower * tenPower - 1);
+    ASSERT_EQ((tenPower * tenPower).toString(), "1" + std::string(12000, '0'));
+}
+
+TEST(BigInteger, MultiplyHuge) {
+    auto a = makeLarge(3500, 4);
+    auto b = makeLarge(3200, 5);
+    auto c = makeLarge(900, 6);
+    ASSERT_EQ(a * (b + c), a * b + a * c);
+    ASSERT_EQ(a * b * c, a * (b * c));
+
+    BigInteger ones("9" + std::string(80000, '9'));
+    ASSERT_EQ(ones * ones, (ones + 1) * (ones + 1) - 2 * (ones + 1) + 1);
+}
+
+TEST(BigInteger, Divmod) {
+    BigInteger a("3345464456576867887943425467865434247657999354657687987987654235345");
+    BigInteger b("-123346576786546566787654356576876865");
+    auto res = a.divmod(b);
+    ASSERT_EQ(res.first, BigInteger("-27122475092002377281597876586575"));
+    ASSERT_EQ(res.second, BigInteger("113978074707290686072881367367147970"));
+    ASSERT_EQ(res.first * b + res.second, a);
+
+    res = (-a).divmod(b);
+    ASSERT_EQ(res.first, BigInteger("27122475092002377281597876586575"));
+    ASSERT_EQ(res.second, BigInteger("-113978074707290686072881367367147970"));
+
+    res = BigInteger(-7).divmod(BigInteger(2));
+    ASSERT_EQ(res.first, -3);
+    ASSERT_EQ(res.second, -1);
+
+    res = BigInteger(5).divmod(a);
+    ASSERT_EQ(res.first, 0);
+    ASSERT_EQ(res.second, 5);
+
+    for (size_t size : {3, 40, 300}) {
+        auto dividend = makeLarge(size * 3, 7);
+        auto divisor = makeLarge(size, 8);
+        auto qr = dividend.divmod(divisor);
+        ASSERT_EQ(qr.first * divisor + qr.second, dividend);
+        ASSERT_TRUE(qr.second >= 0 && qr.second < divisor);
+    }
+
+    ASSERT_THROW({ a.divmod(BigInteger()); }, std::invalid_argument);
+}
+
+TEST(BigInteger, DivideLarge) {
+    for (size_t size : {130, 500, 1400}) {
+        auto divisor = makeLarge(size, 9);
+        auto quotient = makeLarge(size + size / 3, 10);
+        auto remainder = makeLarge(size / 2, 11);
+        auto dividend = quotient * divisor + remainder;
+        auto qr = dividend.divmod(divisor);
+        ASSERT_EQ(qr.first, quotient);
+        ASSERT_EQ(qr.second, remainder);
+        ASSERT_EQ((-dividend) / divisor, -quotient);
+        ASSERT_EQ(dividend % -divisor, remainder);
+    }
+}
+
+TEST(BigInteger, LongDecimalRoundTrip) {
+    std::string digits;
+    for (int i = 0; digits.size() < 40000; i++)
+        digits += std::to_string(i * 7919 % 100003);
+    digits[0] = '9';
+    ASSERT_EQ(BigInteger(digits).toString(), digits);
+    ASSERT_EQ(BigInteger("-" + digits).toString(), "-" + digits);
+    ASSERT_EQ(BigInteger(std::string(700, '0') + digits).toString(), digits);
+
+    std::string power = "1" + std::string(19 * 64, '0');
+    ASSERT_EQ(BigInteger(power).toString(), power);
+    ASSERT_EQ((BigInteger(power) - 1).toString(), std::string(19 * 64, '9'));
+    ASSERT_EQ((BigInteger(power) * BigInteger(power)).toString(), "1" + std::string(19 * 128, '0'));
+}
+
+TEST(BigInteger, CompoundAssignment) {
+    BigInteger sum;
+    BigInteger step("123456789012345678901234567890");
+    for (int i = 0; i < 1000; i++)
+        sum += step;
+    ASSERT_EQ(sum, step * 1000);
+    for (int i = 0; i < 1500; i++)
+        sum -= step;
+    ASSERT_EQ(sum, step * -500);
+
+    sum *= BigInteger(-4);
+    ASSERT_EQ(sum, step * 2000);
+    sum /= BigInteger(3);
+    ASSERT_EQ(sum, step * 2000 / 3);
+    sum %= BigInteger(-1000);
+    ASSERT_EQ(sum, step * 2000 / 3 % 1000);
+
+    BigInteger self("-98765432109876543210987654321");
+    self += self;
+    ASSERT_EQ(self, BigInteger("-197530864219753086421975308642"));
+    self -= self;
+    ASSERT_EQ(self, 0);
+
+    BigInteger small(7);
+    small -= BigInteger("100000000000000000000000");
+    ASSERT_EQ(small, BigInteger("-99999999999999999999993"));
+}
+
+TEST(BigInteger, RvalueOperators) {
+    BigInteger a("100000000000000000000000000000");
+    BigInteger b("-3");
+    ASSERT_EQ(BigInteger(a) + b, BigInteger("99999999999999999999999999997"));
+    ASSERT_EQ(b + BigInteger(a), BigInteger("99999999999999999999999999997"));
+    ASSERT_EQ(BigInteger(a) - BigInteger(b), BigInteger("100000000000000000000000000003"));
+    ASSERT_EQ(b - BigInteger(a), BigInteger("-100000000000000000000000000003"));
+    ASSERT_EQ(BigInteger(a) * b, BigInteger("-300000000000000000000000000000"));
+    ASSERT_EQ(a * BigInteger(b) * BigInteger(b), a * 9);
+    ASSERT_EQ((a - 1) * 2 + 2, a * 2);
+}
+
+TEST(BigInteger, PowMod) {
+    ASSERT_EQ(powMod(BigInteger(2), BigInteger(10), BigInteger(1000)), BigInteger(24));
+    ASSERT_EQ(powMod(BigInteger(-2), BigInteger(3), BigInteger(5)), BigInteger(2));
+    ASSERT_EQ(powMod(BigInteger(7), BigInteger(0), BigInteger(13)), BigInteger(1));
+    ASSERT_EQ(powMod(BigInteger(7), BigInteger(5), BigInteger(1)), BigInteger(0));
+    ASSERT_EQ(powMod(BigInteger(7), BigInteger(5), BigInteger(-13)), BigInteger(11));
+    ASSERT_THROW(powMod(BigInteger(7), BigInteger(5), BigInteger(0)), std::invalid_argument);
+    ASSERT_THROW(powMod(BigInteger(7), BigInteger(-5), BigInteger(13)), BigInteger::SignException);
+
+    // Fermat's little theorem with the Mersenne prime 2^521 - 1 (odd modulus, Montgomery)
+    BigInteger p = BigInteger(1);
+    for (int i = 0; i < 521; i++)
+        p *= 2;
+    p -= 1;
+    BigInteger a = makeLarge(8, 3) % p;
+    ASSERT_EQ(powMod(a, p - 1, p), BigInteger(1));
+    ASSERT_EQ(powMod(a, p, p), a);
+
+    // even modulus (Barrett) against repeated multiplication
+    BigInteger m = p + 1;
+    BigInteger expected(1);
+    for (int i = 0; i < 300; i++)
+        expected = expected * a % m;
+    ASSERT_EQ(powMod(a, BigInteger(300), m), expected);
+}
+
+TEST(BigInteger, Gcd) {
+    ASSERT_EQ(gcd(BigInteger(12), BigInteger(18)), BigInteger(6));
+    ASSERT_EQ(gcd(BigInteger(-12), BigInteger(18)), BigInteger(6));
+    ASSERT_EQ(gcd(BigInteger(0), BigInteger(-5)), BigInteger(5));
+    ASSERT_EQ(gcd(BigInteger(0), BigInteger(0)), BigInteger(0));
+
+    // sizes on both sides of the Lehmer and half-gcd thresholds
+    for (size_t size : {3, 40, 300, 1000}) {
+        BigInteger common = makeLarge(size / 3 + 1, 5);
+        BigInteger a = makeLarge(size, 6) * common, b = makeLarge(size, 7) * common;
+        BigInteger g = gcd(a, b);
+        ASSERT_EQ(g % common, BigInteger(0));
+        ASSERT_EQ(a % g, BigInteger(0));
+        ASSERT_EQ(b % g, BigInteger(0));
+        ASSERT_EQ(gcd(a / g, b / g), BigInteger(1));
+    }
+}
+
+TEST(BigInteger, ExtendedGcd) {
+    auto [g, x, y] = extendedGcd(BigInteger(240), BigInteger(-46));
+    ASSERT_EQ(g, BigInteger(2));
+    ASSERT_EQ(BigInteger(240) * x + BigInteger(-46) * y, g);
+
+    for (size_t size : {2, 30, 300, 1000}) {
+        BigInteger a = -makeLarge(size, 8), b = makeLarge(size * 3 / 4 + 1, 9) * 6;
+        auto [d, u, v] = extendedGcd(a, b);
+        ASSERT_EQ(a * u + b * v, d);
+        ASSERT_EQ(a % d, BigInteger(0));
+        ASSERT_EQ(b % d, BigInteger(0));
+        ASSERT_TRUE(u.abs() < b.abs() / d);
+    }
+}
+
+TEST(BigInteger, ModInverse) {
+    ASSERT_EQ(modInverse(BigInteger(3), BigInteger(11)), BigInteger(4));
+    ASSERT_EQ(modInverse(BigInteger(-3), BigInteger(11)), BigInteger(7));
+    ASSERT_THROW(modInverse(BigInteger(6), BigInteger(9)), std::invalid_argument);
+    ASSERT_THROW(modInverse(BigInteger(6), BigInteger(0)), std::invalid_argument);
+
+    // a power of two is invertible modulo any odd number
+    BigInteger m = makeLarge(900, 10) * 2 + 1;
+    BigInteger a = powMod(BigInteger(2), BigInteger(40000), m);
+    ASSERT_EQ(a * modInverse(a, m) % m, BigInteger(1));
+
+    BigInteger prime("170141183460469231731687303715884105727");
+    BigInteger b = makeLarge(3, 12);
+    ASSERT_EQ(modInverse(b, prime), powMod(b, prime - 2, prime));
+}
+
+TEST(BigInteger, Roots) {
+    ASSERT_EQ(BigInteger(99).isqrt(), BigInteger(9));
+    ASSERT_EQ(BigInteger(100).isqrt(), BigInteger(10));
+    ASSERT_EQ(BigInteger(-27).iroot(3), BigInteger(-3));
+    ASSERT_EQ(BigInteger(-28).iroot(3), BigInteger(-3));
+    ASSERT_EQ(BigInteger(5).iroot(1), BigInteger(5));
+    ASSERT_THROW(BigInteger(-4).isqrt(), BigInteger::SignException);
+    ASSERT_THROW(BigInteger(4).iroot(0), std::invalid_argument);
+
+    BigInteger a = makeLarge(700, 13);
+    BigInteger square = a * a;
+    ASSERT_EQ(square.isqrt(), a);
+    ASSERT_EQ((square - 1).isqrt(), a - 1);
+    ASSERT_EQ((square + 1).isqrt(), a);
+    ASSERT_TRUE(square.isPerfectSquare());
+    ASSERT_FALSE((square + 1).isPerfectSquare());
+
+    BigInteger b = makeLarge(40, 14);
+    BigInteger fifth = b * b * b * b * b;
+    ASSERT_EQ(fifth.iroot(5), b);
+    ASSERT_EQ((fifth - 1).iroot(5), b - 1);
+    ASSERT_TRUE(fifth.isPerfectPower());
+    ASSERT_TRUE((-fifth).isPerfectPower());
+    ASSERT_FALSE((fifth + 1).isPerfectPower());
+    ASSERT_FALSE(BigInteger(-4).isPerfectPower());
+    ASSERT_TRUE(BigInteger(-8).isPerfectPower());
+
+    // a large odd non-power is rejected by the screens without computing thousands of roots
+    BigInteger odd = (BigInteger(1) << 60000) / BigInteger(7) * 2 + 1;
+    ASSERT_FALSE(odd.isPerfectPower());
+    BigInteger oddCube = (odd >> 40000) * (odd >> 40000) * (odd >> 40000);
+    ASSERT_TRUE(oddCube.isPerfectPower());
+    ASSERT_FALSE((oddCube + 2).isPerfectPower());
+    BigInteger smallRoot(1);
+    for (int i = 0; i < 10007; i++)
+        smallRoot *= 3;
+    ASSERT_TRUE(smallRoot.isPerfectPower());
+    ASSERT_TRUE((-smallRoot).isPerfectPower());
+    ASSERT_FALSE((smallRoot - 2).isPerfectPower());
+}
+
+TEST(BigInteger, Bitwise) {
+    ASSERT_EQ(BigInteger(12) & BigInteger(10), BigInteger(8));
+    ASSERT_EQ(BigInteger(12) | BigInteger(10), BigInteger(14));
+    ASSERT_EQ(BigInteger(12) ^ BigInteger(10), BigInteger(6));
+    ASSERT_EQ(BigInteger(-12) & BigInteger(10), BigInteger(0));
+    ASSERT_EQ(BigInteger(-12) | BigInteger(10), BigInteger(-2));
+    ASSERT_EQ(BigInteger(-12) ^ BigInteger(-10), BigInteger(2));
+    ASSERT_EQ(BigInteger(-1) & 0xFF, BigInteger(0xFF));
+    ASSERT_EQ(~BigInteger(0), BigInteger(-1));
+    ASSERT_EQ(~BigInteger(-5), BigInteger(4));
+
+    // x & -x isolates the lowest set bit
+    BigInteger a = (makeLarge(50, 15) * 2 + 1) << 1000;
+    ASSERT_EQ(a & -a, BigInteger(1) << 1000);
+    ASSERT_EQ((a | ~a), BigInteger(-1));
+    ASSERT_EQ((a ^ a), BigInteger(0));
+    ASSERT_EQ(a.popcount() + (~a & ((BigInteger(1) << a.bitLength()) - 1)).popcount(), a.bitLength());
+
+    ASSERT_EQ(BigInteger(0).bitLength(), 0u);
+    ASSERT_EQ(BigInteger(255).bitLength(), 8u);
+    ASSERT_EQ(BigInteger(-256).bitLength(), 9u);
+    ASSERT_EQ(BigInteger(-1).popcount(), 1u);
+    ASSERT_TRUE(a.testBit(1000));
+    ASSERT_FALSE(a.testBit(999));
+    ASSERT_FALSE(a.testBit(100000));
+    ASSERT_TRUE((-a).testBit(1000));
+    ASSERT_FALSE((-a).testBit(999));
+    ASSERT_TRUE((-a).testBit(100000));
+}
+
+TEST(BigInteger, Shifts) {
+    ASSERT_EQ(BigInteger(3) << 64, BigInteger("55340232221128654848"));
+    ASSERT_EQ(BigInteger(-7) >> 1, BigInteger(-4));
+    ASSERT_EQ(BigInteger(-7) / 2, BigInteger(-3));
+    ASSERT_EQ(BigInteger(-1) >> 1000, BigInteger(-1));
+    ASSERT_EQ(BigInteger(5) >> 1000, BigInteger(0));
+    ASSERT_EQ(BigInteger(0) << 1000, BigInteger(0));
+
+    BigInteger a = makeLarge(40, 16);
+    for (size_t shift : {0, 1, 63, 64, 65, 200, 2560}) {
+        BigInteger power = BigInteger(1) << shift;
+        ASSERT_EQ(a << shift, a * power);
+        ASSERT_EQ((a << shift) >> shift, a);
+        ASSERT_EQ(a >> shift, a / power);
+        ASSERT_EQ(-a >> shift, (-a - power + 1) / power);
+        ASSERT_EQ(a % power, a - (a >> shift << shift));
+
+        BigInteger b = a;
+        b <<= shift;
+        ASSERT_EQ(b, a << shift);
+        b >>= shift + 3;
+        ASSERT_EQ(b, a >> 3);
+    }
+}
+
+TEST(BigInteger, SumAndProduct) {
+    std::vector<BigInteger> values = {makeLarge(30, 17), BigInteger(-5), makeLarge(70, 18), BigInteger(3)};
+    ASSERT_EQ(BigInteger::sum(values), values[0] + values[1] + values[2] + values[3]);
+    ASSERT_EQ(BigInteger::product(values), values[0] * values[1] * values[2] * values[3]);
+    ASSERT_EQ(BigInteger::sum(std::vector<BigInteger>()), BigInteger(0));
+    ASSERT_EQ(BigInteger::product(std::vector<BigInteger>()), BigInteger(1));
+
+    std::vector<int64_t> small;
+    BigInteger folded(1);
+    for (int64_t i = 1; i <= 300; i++) {
+        small.push_back(i);
+        folded *= i;
+    }
+    ASSERT_EQ(BigInteger::product(small.begin(), small.end()), folded);
+    ASSERT_EQ(BigInteger::sum(small), BigInteger(300 * 301 / 2));
+
+    // long long and unsigned long long are distinct from int64_t and uint64_t on LP64 targets
+    std::vector<long long> longs = {LLONG_MAX, LLONG_MIN, 3};
+    ASSERT_EQ(BigInteger::sum(longs), BigInteger(2));
+    ASSERT_EQ(BigInteger::product(longs), BigInteger(LLONG_MAX) * BigInteger(LLONG_MIN) * 3);
+    std::vector<unsigned long long> unsignedLongs = {ULLONG_MAX, 2};
+    ASSERT_EQ(BigInteger::product(unsignedLongs), BigInteger::from(ULLONG_MAX) << 1);
+    ASSERT_EQ(BigInteger::from(5LL), BigInteger(5));
+    ASSERT_EQ(BigInteger::from('A'), BigInteger(65));
+    ASSERT_EQ(BigInteger::from(-7LL).value<long long>(), -7LL);
+    ASSERT_EQ(BigInteger::from(7ULL).value<unsigned long long>(), 7ULL);
+    ASSERT_EQ(BigInteger(120).value<char>(), 'x');
+    ASSERT_FALSE(BigInteger(300).fitsIn<char>());
+    ASSERT_TRUE(BigInteger(-1).fitsIn<long long>());
+    ASSERT_FALSE(BigInteger(-1).fitsIn<unsigned long long>());
+}
+
+TEST(BigInteger, Combinatorics) {
+    ASSERT_EQ(factorial(0), BigInteger(1));
+    ASSERT_EQ(factorial(20), BigInteger(2432902008176640000));
+    ASSERT_EQ(factorial(30), BigInteger("265252859812191058636308480000000"));
+    BigInteger folded(1);
+    for (int64_t i = 2; i <= 2000; i++)
+        folded *= i;
+    ASSERT_EQ(factorial(2000), folded);
+
+    ASSERT_EQ(binomial(5, 7), BigInteger(0));
+    ASSERT_EQ(binomial(10, 0), BigInteger(1));
+    ASSERT_EQ(binomial(52, 5), BigInteger(2598960));
+    ASSERT_EQ(binomial(2000, 700), factorial(2000) / (factorial(700) * factorial(1300)));
+    ASSERT_EQ(binomial(1000000, 2), BigInteger(499999500000));
+    ASSERT_EQ(binomial(UINT64_MAX, 1), BigInteger::from(UINT64_MAX));
+
+    ASSERT_EQ(primorial(1), BigInteger(1));
+    ASSERT_EQ(primorial(30), BigInteger(6469693230));
+}
+
+TEST(BigInteger, Serialization) {
+    std::vector<BigInteger> values = {BigInteger(0), BigInteger(1), BigInteger(-1), makeLarge(3, 19),
+                                      -makeLarge(20, 20), makeLarge(200, 21)};
+    std::stringstream stream;
+    for (const auto &value : values) {
+        std::vector<unsigned char> buffer(value.serializedSize());
+        ASSERT_EQ(value.serialize(buffer.data()), buffer.size());
+        size_t consumed = 0;
+        ASSERT_EQ(BigInteger::deserialize(buffer.data(), buffer.size(), &consumed), value);
+        ASSERT_EQ(consumed, buffer.size());
+        value.serialize(stream);
+    }
+    for (const auto &value : values)
+        ASSERT_EQ(BigInteger::deserialize(stream), value);
+    ASSERT_THROW(BigInteger::deserialize(stream), std::invalid_argument);
+
+    ASSERT_EQ(BigInteger(0).serializedSize(), 1u);
+    // 2 limbs, negative
+    unsigned char bytes[17] = {5, 1, 0, 0, 0, 0, 0, 0, 0, 2};
+    ASSERT_EQ(BigInteger::deserialize(bytes, sizeof(bytes)), -(BigInteger(2) << 64) - 1);
+    ASSERT_THROW(BigInteger::deserialize(bytes, 16), std::invalid_argument);
+    // negative zero, a zero top limb and a redundant varint byte
+    unsigned char negativeZero[1] = {1};
+    ASSERT_THROW(BigInteger::deserialize(negativeZero, 1), std::invalid_argument);
+    unsigned char zeroTop[9] = {2};
+    ASSERT_THROW(BigInteger::deserialize(zeroTop, 9), std::invalid_argument);
+    unsigned char padded[2] = {0x80, 0};
+    ASSERT_THROW(BigInteger::deserialize(padded, 2), std::invalid_argument);
+    unsigned char huge[10] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01};
+    ASSERT_THROW(BigInteger::deserialize(huge, 10), std::invalid_argument);
+    ASSERT_THROW(BigInteger::deserialize(huge, 0), std::invalid_argument);
+}
+
+TEST(BigInteger, FromChars) {
+    std::string text = "-123456789012345678901234567890 rest";
+    BigInteger value(5);
+    auto [ptr, ec] = from_chars(text.data(), text.data() + text.size(), value);
+    ASSERT_EQ(ec, std::errc());
+    ASSERT_EQ(ptr, text.data() + 31);
+    ASSERT_EQ(value, BigInteger("-123456789012345678901234567890"));
+
+    for (const char *invalid : {"", "-", " 1", "+1", "x"}) {
+        std::string_view str(invalid);
+        auto res = from_chars(str.data(), str.data() + str.size(), value);
+        ASSERT_EQ(res.ec, std::errc::invalid_argument);
+        ASSERT_EQ(res.ptr, str.data());
+    }
+    ASSERT_EQ(value, BigInteger("-123456789012345678901234567890"));
+
+    std::string_view zero = "-000";
+    ASSERT_EQ(from_chars(zero.data(), zero.data() + zero.size(), value).ec, std::errc());
+    ASSERT_EQ(value, BigInteger(0));
+    ASSERT_EQ(-value, value);
+
+    std::string digits(5000, '7');
+    ASSERT_EQ(BigInteger(std::string_view(digits)).toString(), digits);
+    ASSERT_EQ(BigInteger(" \t42\n"), BigInteger(42));
+    ASSERT_THROW(BigInteger("4 2"), std::invalid_argument);
+}
+
+TEST(BigInteger, ToChars) {
+    // lengths around powers of ten and of two, where the length bound is tightest
+    std::vector<BigInteger> values = {BigInteger(0), BigInteger(9), BigInteger(-10), BigInteger(INT64_MIN)};
+    for (size_t digits : {19, 20, 39, 40, 600, 2000}) {
+        BigInteger power(std::string("1") + std::string(digits, '0'));
+        values.push_back(power);
+        values.push_back(power - 1);
+        values.push_back(-(power - 1));
+    }
+    for (size_t bits : {63, 64, 127, 128, 1000, 7000})
+        values.push_back((BigInteger(1) << bits) - 1);
+
+    for (const auto &value : values) {
+        std::string expected = value.toString();
+        ASSERT_GE(value.decimalLength(), expected.size());
+        ASSERT_LE(value.decimalLength(), expected.size() + 1);
+
+        std::string buffer(expected.size() + 1, '#');
+        auto [ptr, ec] = to_chars(&buffer[0], &buffer[0] + expected.size(), value);
+        ASSERT_EQ(ec, std::errc());
+        ASSERT_EQ(std::string(buffer.data(), ptr), expected);
+        ASSERT_EQ(buffer.back(), '#');
+
+        auto res = to_chars(&buffer[0], &buffer[0] + expected.size() - 1, value);
+        ASSERT_EQ(res.ec, std::errc::value_too_large);
+        ASSERT_EQ(res.ptr, &buffer[0] + expected.size() - 1);
+    }
+}
+
+TEST(BigInteger, ShortParsesDoNotAllocate) {
+    // warm up anything allocated once per thread
+    BigInteger value("1");
+    size_t before = heapAllocations;
+    for (const char *text : {"7", "-18446744073709551615", "340282366920938463463374607431768211455", "0"}) {
+        std::string_view str(text);
+        ASSERT_EQ(from_chars(str.data(), str.data() + str.size(), value).ec, std::errc());
+        value = BigInteger(str);
+        BigIntegerParser parser;
+        parser.feed(str);
+        ASSERT_EQ(parser.finish(value), std::errc());
+    }
+    size_t after = heapAllocations;
+    ASSERT_EQ(after, before);
+    ASSERT_EQ(value, BigInteger(0));
+
+    // more than two limbs have to go to the heap
+    value = BigInteger("340282366920938463463374607431768211456");
+    after = heapAllocations;
+    ASSERT_GT(after, before);
+    ASSERT_EQ(value, BigInteger(1) << 128);
+}
+
+TEST(BigInteger, ToCharsDoesNotAllocate) {
+    BigInteger nine(9), large = -((BigInteger(1) << 1200) - 1);
+    std::vector<BigInteger> values = {nine, BigInteger(INT64_MIN), (BigInteger(1) << 128) - 1, large};
+    std::vector<std::string> expected;
+    for (const auto &value : values)
+        expected.push_back(value.toString());
+
+    char buffer[400];
+    to_chars(buffer, buffer + sizeof(buffer), nine);
+    size_t before = heapAllocations;
+    for (size_t i = 0; i < values.size(); i++) {
+        auto [ptr, ec] = to_chars(buffer, buffer + sizeof(buffer), values[i]);
+        ASSERT_EQ(ec, std::errc());
+        ASSERT_EQ(ptr - buffer, static_cast<ptrdiff_t>(expected[i].size()));
+    }
+    // the length bound of 9 is one too high, and a buffer of the exact length still takes it
+    ASSERT_EQ(nine.decimalLength(), 2u);
+    auto res = to_chars(buffer, buffer + 1, nine);
+    ASSERT_EQ(res.ec, std::errc());
+    ASSERT_EQ(res.ptr, buffer + 1);
+    ASSERT_EQ(buffer[0], '9');
+    ASSERT_EQ(to_chars(buffer, buffer + 360, large).ec, std::errc::value_too_large);
+    size_t after = heapAllocations;
+    ASSERT_EQ(after, before);
+}
+
+TEST(BigInteger, Int64Operands) {
+    BigInteger large = makeLarge(3, 22);
+    for (int64_t val : {int64_t(0), int64_t(1), int64_t(-1), int64_t(1) << 40, INT64_MAX, INT64_MIN}) {
+        BigInteger big(val);
+        for (const BigInteger &a : {BigInteger(0), BigInteger(-5), large, -large, BigInteger(val)}) {
+            ASSERT_EQ(a + val, a + big);
+            ASSERT_EQ(a - val, a - big);
+            ASSERT_EQ(val - a, big - a);
+            ASSERT_EQ(a * val, a * big);
+            ASSERT_EQ(a < val, a < big);
+            ASSERT_EQ(a == val, a == big);
+            if (val != 0) {
+                ASSERT_EQ(a / val, a / big);
+                ASSERT_EQ(a % val, a % big);
+            }
+            if (a != 0) {
+                ASSERT_EQ(val / a, big / a);
+                ASSERT_EQ(val % a, big % a);
+            }
+        }
+    }
+    // zero never turns negative
+    ASSERT_EQ(0 - BigInteger(0), BigInteger(0));
+    ASSERT_EQ(BigInteger(-7) * int64_t(0), BigInteger(0));
+    ASSERT_FALSE(BigInteger(-7) % 7 < 0);
+    ASSERT_THROW(large % int64_t(0), std::invalid_argument);
+    ASSERT_THROW(int64_t(3) / BigInteger(0), std::invalid_argument);
+}
+
+TEST(BigInteger, FloatingPoint) {
+    BigInteger twoTo53 = BigInteger(1) << 53;
+    // ties go to the even neighbour
+    ASSERT_EQ((twoTo53 + 1).toDouble(), 9007199254740992.0);
+    ASSERT_EQ((twoTo53 + 3).toDouble(), 9007199254740996.0);
+    ASSERT_EQ(((twoTo53 + 1) << 1000).toDouble(), std::ldexp(9007199254740992.0, 1000));
+    ASSERT_EQ((((twoTo53 + 1) << 1000) + 1).toDouble(), std::ldexp(9007199254740994.0, 1000));
+    ASSERT_EQ((-(twoTo53 - 1) << 971).toDouble(), -std::numeric_limits<double>::max());
+    // halfway between the largest double and 2^1024
+    ASSERT_EQ(((BigInteger(1) << 1024) - (BigInteger(1) << 970)).toDouble(), INFINITY);
+    ASSERT_EQ(((BigInteger(1) << 1024) - (BigInteger(1) << 970) - 1).toDouble(), std::numeric_limits<double>::max());
+    ASSERT_EQ((BigInteger(1) << 5000).toDouble(), INFINITY);
+    ASSERT_EQ(((BigInteger(1) << 64) + 1).toLongDouble(), std::ldexp(1.0L, 64));
+    ASSERT_EQ(((BigInteger(1) << 70) + 1).toLongDouble(), std::ldexp(1.0L, 70));
+
+    for (double d : {0.0, 1.0, -2.5, 1e18, -1e300, 123456789.987, 0.999}) {
+        ASSERT_EQ(BigInteger::from(d).toDouble(), std::trunc(d));
+        ASSERT_EQ(BigInteger::from(static_cast<long double>(d)).toLongDouble(), std::trunc(static_cast<long double>(d)));
+    }
+    ASSERT_EQ(BigInteger::from(std::ldexp(1.0, 200)), BigInteger(1) << 200);
+    ASSERT_EQ(BigInteger::from(-0.5), BigInteger(0));
+    ASSERT_THROW(BigInteger::from(NAN), std::invalid_argument);
+    ASSERT_THROW(BigInteger::from(-INFINITY), std::invalid_argument);
+
+    // operands far beyond the double range with an ordinary quotient
+    BigInteger huge = BigInteger(10) << 3000;
+    ASSERT_EQ((huge * 3).realDivide(huge), 3.0);
+    ASSERT_EQ((-huge).realDivide(huge * 4), -0.25);
+    ASSERT_EQ(BigInteger(1).realDivide(3), 1.0 / 3);
+    ASSERT_EQ(BigInteger(1).realDivide(huge), 0.0);
+    ASSERT_EQ(huge.realDivide(1), INFINITY);
+
+    // subnormal quotients round once at their own last place, 2^-1074
+    double minSubnormal = std::numeric_limits<double>::denorm_min();
+    BigInteger big = BigInteger(1) << 1200;
+    ASSERT_EQ(((big >> 1075) + 1).realDivide(big), minSubnormal);
+    ASSERT_EQ((big >> 1075).realDivide(big), 0.0);
+    ASSERT_EQ((-(big >> 1075) * 3).realDivide(big), -2 * minSubnormal);
+    ASSERT_EQ((big >> 1074).realDivide(big * 3), 0.0);
+    ASSERT_EQ((big >> 1060).realDivide(big * 3), std::ldexp(5461.0, -1074));
+    ASSERT_EQ(((big >> 1022) - 1).realDivide(big), std::numeric_limits<double>::min());
+}
+
+TEST(BigInteger, Int128) {
+    __int128 min = -(static_cast<__int128>(1) << 126) * 2;
+    unsigned __int128 max = ~static_cast<unsigned __int128>(0);
+    ASSERT_EQ(BigInteger::from(min), -(BigInteger(1) << 127));
+    ASSERT_EQ(BigInteger::from(max), (BigInteger(1) << 128) - 1);
+    ASSERT_EQ(BigInteger::from(static_cast<__int128>(-5)), BigInteger(-5));
+    ASSERT_EQ(BigInteger::from(static_cast<unsigned __int128>(1) << 64), BigInteger(1) << 64);
+    ASSERT_TRUE(BigInteger::from(min).value<__int128>() == min);
+    ASSERT_TRUE(BigInteger::from(max).value<unsigned __int128>() == max);
+
+    ASSERT_TRUE((BigInteger(1) << 127).fitsIn<unsigned __int128>());
+    ASSERT_FALSE((BigInteger(1) << 127).fitsIn<__int128>());
+    ASSERT_TRUE((-(BigInteger(1) << 127)).fitsIn<__int128>());
+    ASSERT_FALSE((BigInteger(1) << 128).fitsIn<unsigned __int128>());
+    ASSERT_FALSE(BigInteger(-1).fitsIn<uint8_t>());
+    ASSERT_TRUE(BigInteger(-128).fitsIn<int8_t>());
+    ASSERT_FALSE(BigInteger(128).fitsIn<int8_t>());
+    ASSERT_THROW(BigInteger(-1).value<unsigned __int128>(), BigInteger::SignException);
+    ASSERT_THROW((BigInteger(1) << 127).value<__int128>(), BigInteger::OverflowException);
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include "../src/BigRational.h"
+
+using namespace BigNum;
+
+TEST(BigRational, ArithmeticIsExact) {
+    BigRational third(BigInteger(1), BigInteger(3));
+    BigRational sum;
+    for (int i = 0; i < 3; i++)
+        sum += third;
+    ASSERT_EQ(sum, BigRational(1));
+    ASSERT_EQ(sum.numerator(), BigInteger(1));
+    ASSERT_EQ(sum.denominator(), BigInteger(1));
+
+    BigRational a(BigInteger(-6), BigInteger(-4));
+    ASSERT_FALSE(a.isNormalized());
+    ASSERT_EQ(a.toString(), "3/2");
+    ASSERT_TRUE(a.isNormalized());
+    ASSERT_EQ(BigRational(BigInteger(5), BigInteger(-10)).toString(), "-1/2");
+
+    BigRational b(BigInteger(7), BigInteger(10));
+    ASSERT_EQ((a - b).toString(), "4/5");
+    ASSERT_EQ((a * b).toString(), "21/20");
+    ASSERT_EQ((a / b).toString(), "15/7");
+    ASSERT_EQ((b / -a).toString(), "-7/15");
+    ASSERT_EQ((a + 2).toString(), "7/2");
+    ASSERT_THROW(a / BigRational(), std::invalid_argument);
+    ASSERT_THROW(BigRational(BigInteger(1), BigInteger(0)), std::invalid_argument);
+}
+
+TEST(BigRational, SelfAssignmentOperators) {
+    BigRational r(BigInteger(-3), BigInteger(7));
+    r /= r;
+    ASSERT_EQ(r.toString(), "1");
+
+    r = BigRational(BigInteger(-3), BigInteger(7));
+    r *= r;
+    ASSERT_EQ(r.toString(), "9/49");
+    r += r;
+    ASSERT_EQ(r.toString(), "18/49");
+    r -= r;
+    ASSERT_EQ(r.toString(), "0");
+    ASSERT_THROW(r /= r, std::invalid_argument);
+}
+
+TEST(BigRational, NormalizesLazily) {
+    // the harmonic sum keeps growing denominators, which get reduced once they pass the threshold
+    BigRational sum;
+    for (int64_t i = 1; i <= 200; i++) {
+        sum += BigRational(BigInteger(1), BigInteger(i));
+        if (i == 3) {
+            ASSERT_FALSE(sum.isNormalized());
+        }
+    }
+    BigRational reduced = sum;
+    reduced.normalize();
+    ASSERT_EQ(sum, reduced);
+    ASSERT_EQ(sum.toDouble(), 5.878030948121444);
+    ASSERT_EQ(sum.denominator().toString().size(), 89u);
+}
+
+TEST(BigRational, Compare) {
+    BigRational half(BigInteger(1), BigInteger(2));
+    BigRational twoQuarters(BigInteger(2), BigInteger(4));
+    ASSERT_EQ(half, twoQuarters);
+    ASSERT_FALSE(half < twoQuarters);
+    ASSERT_LT(BigRational(BigInteger(-1), BigInteger(3)), half);
+    ASSERT_LT(BigRational(BigInteger(-1), BigInteger(2)), BigRational(BigInteger(-1), BigInteger(3)));
+    ASSERT_GT(BigRational(BigInteger(1) << 200), BigRational(BigInteger(3), BigInteger(7)));
+    ASSERT_LT(BigRational(BigInteger(1), BigInteger(1) << 200), BigRational(BigInteger(1), BigInteger(1) << 199));
+    ASSERT_GE(BigRational(), BigRational(-1));
+    ASSERT_NE(half, BigRational(BigInteger(3), BigInteger(7)));
+}
+
+TEST(BigRational, Formatting) {
+    BigRational twoThirds(BigInteger(2), BigInteger(3));
+    ASSERT_EQ(twoThirds.toDecimalString(5), "0.66667");
+    ASSERT_EQ((-twoThirds).toDecimalString(0), "-1");
+    ASSERT_EQ(BigRational(BigInteger(1), BigInteger(8)).toDecimalString(2), "0.13");
+    ASSERT_EQ(BigRational(BigInteger(-1), BigInteger(1000)).toDecimalString(2), "0.00");
+    ASSERT_EQ(BigRational(BigInteger(12345), BigInteger(100)).toDecimalString(3), "123.450");
+    ASSERT_EQ(BigRational(-7).toString(), "-7");
+    ASSERT_EQ(twoThirds.toDouble(), 2.0 / 3);
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "../src/CachedBigInteger.h"
+
+using namespace BigNum;
+
+TEST(CachedBigInteger, RendersOnce) {
+    CachedBigInteger balance(BigInteger("-123456789012345678901234567890"));
+    ASSERT_FALSE(balance.isCached());
+    const std::string &text = balance.toString();
+    ASSERT_EQ(text, "-123456789012345678901234567890");
+    ASSERT_TRUE(balance.isCached());
+    ASSERT_EQ(&balance.toString(), &text);
+    ASSERT_EQ(balance.decimalLength(), text.size());
+
+    char buffer[40];
+    auto [ptr, ec] = to_chars(buffer, buffer + sizeof(buffer), balance);
+    ASSERT_EQ(ec, std::errc());
+    ASSERT_EQ(std::string(buffer, ptr), text);
+    ASSERT_EQ(to_chars(buffer, buffer + 30, balance).ec, std::errc::value_too_large);
+}
+
+TEST(CachedBigInteger, MutationInvalidates) {
+    CachedBigInteger value(BigInteger(99));
+    ASSERT_EQ(value.toString(), "99");
+    value += 1;
+    ASSERT_FALSE(value.isCached());
+    ASSERT_EQ(value.toString(), "100");
+    value *= BigInteger("-1000000000000000000000");
+    ASSERT_EQ(value.toString(), "-100000000000000000000000");
+    value -= BigInteger("-100000000000000000000000");
+    ASSERT_EQ(value.toString(), "0");
+    value.modify([](BigInteger &v) { v = BigInteger(1) << 100; });
+    ASSERT_EQ(value.toString(), "1267650600228229401496703205376");
+    value = BigInteger(-7);
+    ASSERT_EQ(value.toString(), "-7");
+    ASSERT_EQ(value.value(), BigInteger(-7));
+    ASSERT_LE(static_cast<const BigInteger &>(value), BigInteger(0));
+}
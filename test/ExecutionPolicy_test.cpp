@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include "../src/BigInteger.h"
+#include "../src/ExecutionPolicy.h"
+
+using namespace BigNum;
+
+namespace {
+    // value of exactly the given number of limbs built by repeated squaring
+    BigInteger largeValue(size_t limbs, int64_t seed) {
+        BigInteger res(seed);
+        while (res.bitLength() < 64 * limbs)
+            res = res * res + seed;
+        return res >> (res.bitLength() - 64 * limbs);
+    }
+}
+
+TEST(ExecutionPolicy, ScopesNest) {
+    ASSERT_EQ(currentExecutionPolicy().threads, 1u);
+    {
+        ExecutionScope outer(ExecutionPolicy::parallel(4, 100));
+        ASSERT_EQ(currentExecutionPolicy().threads, 4u);
+        ASSERT_EQ(currentExecutionPolicy().minLimbs, 100u);
+        ASSERT_TRUE(kernels::runParallel(100));
+        ASSERT_FALSE(kernels::runParallel(99));
+        {
+            ExecutionScope inner(ExecutionPolicy::sequential());
+            ASSERT_FALSE(kernels::runParallel(100000));
+        }
+        ASSERT_EQ(currentExecutionPolicy().threads, 4u);
+    }
+    ASSERT_EQ(currentExecutionPolicy().threads, 1u);
+
+    setDefaultExecutionPolicy(ExecutionPolicy::parallel(3));
+    ASSERT_EQ(currentExecutionPolicy().threads, 3u);
+    setDefaultExecutionPolicy(ExecutionPolicy::sequential());
+    ASSERT_EQ(currentExecutionPolicy().threads, 1u);
+}
+
+TEST(ExecutionPolicy, ParallelFor) {
+    ExecutionScope scope(ExecutionPolicy::parallel(4, 0));
+    std::vector<std::atomic<int>> calls(1000);
+    kernels::parallelFor(calls.size(), [&](size_t i) {
+        // nested loops run on the calling thread
+        ASSERT_FALSE(kernels::runParallel(1000000));
+        kernels::parallelFor(2, [&](size_t) { calls[i]++; });
+    });
+    for (auto &count : calls)
+        ASSERT_EQ(count, 2);
+
+    ASSERT_THROW(kernels::parallelFor(100, [](size_t i) {
+        if (i == 57)
+            throw std::runtime_error("failed");
+    }), std::runtime_error);
+    ASSERT_TRUE(kernels::runParallel(0));
+}
+
+TEST(ExecutionPolicy, ParallelProductsMatch) {
+    auto a = largeValue(9000, 7);
+    auto b = largeValue(5000, 11);
+    auto expected = a * b;
+    auto square = a * a;
+    for (unsigned threads : {2, 3, 8}) {
+        auto policy = ExecutionPolicy::parallel(threads, 1000);
+        ASSERT_EQ(multiply(a, b, policy), expected);
+        ASSERT_EQ(multiply(a, a, policy), square);
+        ASSERT_EQ(multiply(a, b >> 2000 * 64, policy), a * (b >> 2000 * 64));
+    }
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include "../src/FixedInt.h"
+
+using namespace BigNum;
+
+namespace {
+    // random value of the given number of bits, negative half of the time
+    BigInteger randomValue(std::mt19937_64 &gen, size_t bits) {
+        BigInteger res;
+        for (size_t i = 0; i < bits; i += 64)
+            res = (res << 64) + BigInteger::from(gen());
+        res = res >> (res.bitLength() > bits ? res.bitLength() - bits : 0);
+        return gen() % 2 ? -res : res;
+    }
+
+    BigInteger wrap(const BigInteger &val, size_t bits, bool isSigned) {
+        BigInteger modulus = BigInteger(1) << bits;
+        BigInteger res = val % modulus;
+        if (res < 0)
+            res += modulus;
+        if (isSigned && res.testBit(bits - 1))
+            res -= modulus;
+        return res;
+    }
+}
+
+TEST(FixedInt, ConstexprArithmetic) {
+    constexpr FixedUInt<128> a = FixedUInt<128>(UINT64_MAX) + 1;
+    static_assert(a.data()[1] == 1 && a.data()[0] == 0, "carry into the second limb");
+    static_assert((a * a).isZero(), "2^128 wraps to zero");
+    static_assert((a - 1).data()[0] == UINT64_MAX, "borrow from the second limb");
+    static_assert(FixedInt<256>(-5) < FixedInt<256>(3), "signed comparison");
+    static_assert(FixedInt<256>(-7) / FixedInt<256>(2) == FixedInt<256>(-3), "truncating division");
+    static_assert(FixedInt<256>(-7) % FixedInt<256>(2) == FixedInt<256>(-1), "remainder sign");
+    static_assert((FixedInt<128>(-1) >> 100) == FixedInt<128>(-1), "arithmetic shift");
+    static_assert((a >> 64) == FixedUInt<128>(1), "logical shift");
+    ASSERT_EQ(a.toString(), "18446744073709551616");
+}
+
+TEST(FixedInt, MatchesBigInteger) {
+    std::mt19937_64 gen(5);
+    for (int round = 0; round < 300; round++) {
+        BigInteger x = randomValue(gen, 1 + gen() % 512), y = randomValue(gen, 1 + gen() % 512);
+        FixedInt<512> a(x), b(y);
+        FixedUInt<512> ua(x), ub(y);
+        ASSERT_EQ(a.toBigInteger(), wrap(x, 512, true));
+        ASSERT_EQ(ua.toBigInteger(), wrap(x, 512, false));
+
+        ASSERT_EQ((a + b).toBigInteger(), wrap(a.toBigInteger() + b.toBigInteger(), 512, true));
+        ASSERT_EQ((a - b).toBigInteger(), wrap(a.toBigInteger() - b.toBigInteger(), 512, true));
+        ASSERT_EQ((a * b).toBigInteger(), wrap(a.toBigInteger() * b.toBigInteger(), 512, true));
+        ASSERT_EQ((ua * ub).toBigInteger(), wrap(ua.toBigInteger() * ub.toBigInteger(), 512, false));
+        ASSERT_EQ(a < b, a.toBigInteger() < b.toBigInteger());
+        ASSERT_EQ(ua < ub, ua.toBigInteger() < ub.toBigInteger());
+        if (!b.isZero()) {
+            ASSERT_EQ((a / b).toBigInteger(), a.toBigInteger() / b.toBigInteger());
+            ASSERT_EQ((a % b).toBigInteger(), a.toBigInteger() % b.toBigInteger());
+            ASSERT_EQ((ua / ub).toBigInteger(), ua.toBigInteger() / ub.toBigInteger());
+            ASSERT_EQ((ua % ub).toBigInteger(), ua.toBigInteger() % ub.toBigInteger());
+        }
+        size_t shift = gen() % 600;
+        ASSERT_EQ((a >> shift).toBigInteger(), a.toBigInteger() >> shift);
+        ASSERT_EQ((a << shift).toBigInteger(), wrap(a.toBigInteger() << shift, 512, true));
+    }
+}
+
+TEST(FixedInt, CheckedOverflow) {
+    using Checked = FixedInt<128, Overflow::Checked>;
+    using CheckedUnsigned = FixedUInt<128, Overflow::Checked>;
+    ASSERT_THROW(Checked::max() + 1, BigInteger::OverflowException);
+    ASSERT_THROW(Checked::min() - 1, BigInteger::OverflowException);
+    ASSERT_THROW(-Checked::min(), BigInteger::OverflowException);
+    ASSERT_THROW(Checked::min() / -1, BigInteger::OverflowException);
+    ASSERT_THROW(Checked(int64_t(1) << 62) * Checked(int64_t(1) << 62) * 8, BigInteger::OverflowException);
+    ASSERT_EQ(Checked(INT64_MIN) * Checked(INT64_MIN) * -2, Checked::min());
+    ASSERT_THROW(Checked(1) << 127, BigInteger::OverflowException);
+    ASSERT_EQ(Checked(-1) << 127, Checked::min());
+
+    ASSERT_THROW(CheckedUnsigned(0) - 1, BigInteger::OverflowException);
+    ASSERT_THROW(CheckedUnsigned(-1), BigInteger::OverflowException);
+    ASSERT_THROW(CheckedUnsigned(BigInteger(1) << 128), BigInteger::OverflowException);
+    ASSERT_EQ(CheckedUnsigned((BigInteger(1) << 128) - 1), CheckedUnsigned::max());
+    ASSERT_EQ(Checked(-(BigInteger(1) << 127)), Checked::min());
+    ASSERT_THROW(Checked(BigInteger(1) << 127), BigInteger::OverflowException);
+    ASSERT_THROW(Checked(5) / 0, std::invalid_argument);
+
+    // the wrapping types reduce instead
+    ASSERT_EQ(FixedUInt<128>(0) - 1, FixedUInt<128>::max());
+    ASSERT_EQ(FixedInt<128>::max() + 1, FixedInt<128>::min());
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include "../src/BigInteger.h"
+#include "../src/Instrumentation.h"
+
+using namespace BigNum;
+
+TEST(Instrumentation, Histogram) {
+    Histogram histogram;
+    for (uint64_t value : {0, 1, 2, 3, 4, 1000})
+        histogram.add(value);
+    ASSERT_EQ(histogram.counts[0], 1u);
+    ASSERT_EQ(histogram.counts[1], 1u);
+    ASSERT_EQ(histogram.counts[2], 2u);
+    ASSERT_EQ(histogram.counts[3], 1u);
+    ASSERT_EQ(histogram.counts[10], 1u);
+    ASSERT_EQ(histogram.total(), 6u);
+}
+
+TEST(Instrumentation, RecordsOperations) {
+    BigInteger a("123456789012345678901234567890123456789012345678901234567890");
+    BigInteger b("987654321098765432109876543210");
+    resetInstrumentation();
+
+    BigInteger c = a * b;
+    c = c % b;
+    c += 5;
+    ASSERT_TRUE(c < a);
+
+    auto stats = instrumentationSnapshot();
+    if (!INSTRUMENTATION_ENABLED) {
+        ASSERT_EQ(stats[Operation::Multiply].calls, 0u);
+        ASSERT_EQ(stats.allocations, 0u);
+        return;
+    }
+    ASSERT_EQ(stats[Operation::Multiply].calls, 1u);
+    ASSERT_EQ(stats[Operation::Multiply].limbs.counts[3], 1u);
+    ASSERT_EQ(stats[Operation::Multiply].nanoseconds.total(), 1u);
+    // the division inside operator% and the comparison inside it belong to the modulo
+    ASSERT_EQ(stats[Operation::Modulo].calls, 1u);
+    ASSERT_EQ(stats[Operation::DivMod].calls, 0u);
+    ASSERT_EQ(stats[Operation::Add].calls, 1u);
+    ASSERT_EQ(stats[Operation::Compare].calls, 1u);
+    ASSERT_EQ(stats[Algorithm::MulBasecase], 1u);
+    ASSERT_EQ(stats[Algorithm::DivSchoolbook], 1u);
+    // the six limb product spills out of the inline storage
+    ASSERT_GE(stats[Operation::Multiply].allocations, 1u);
+    ASSERT_GE(stats.allocations, stats[Operation::Multiply].allocations);
+
+    resetInstrumentation();
+    ASSERT_EQ(instrumentationSnapshot()[Operation::Multiply].calls, 0u);
+    ASSERT_EQ(std::string(operationName(Operation::PowMod)), "powMod");
+    ASSERT_EQ(std::string(algorithmName(Algorithm::MulNtt)), "mulNtt");
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "../src/BigInteger.h"
+#include "../src/LimbResources.h"
+#include "../src/LimbStorage.h"
+
+using namespace BigNum;
+
+TEST(LimbResources, ScopeSelectsResource) {
+    LimbArena arena;
+    ASSERT_EQ(currentResource(), std::pmr::get_default_resource());
+    {
+        ResourceScope scope(&arena);
+        ASSERT_EQ(currentResource(), &arena);
+        LimbStorage storage;
+        storage.resize(10);
+        ASSERT_EQ(storage.resource(), &arena);
+        {
+            LimbPool pool;
+            ResourceScope inner(&pool);
+            ASSERT_EQ(currentResource(), &pool);
+        }
+        ASSERT_EQ(currentResource(), &arena);
+    }
+    ASSERT_EQ(currentResource(), std::pmr::get_default_resource());
+}
+
+TEST(LimbResources, CopyOutOfArena) {
+    BigInteger expected("123456789012345678901234567890123456789012345678901234567890");
+    BigInteger result;
+    {
+        LimbArena arena;
+        ResourceScope scope(&arena);
+        BigInteger a("340282366920938463463374607431768211457");
+        BigInteger b = expected * a;
+        result = BigInteger(b / a, std::pmr::get_default_resource());
+    }
+    ASSERT_EQ(result, expected);
+    ASSERT_EQ(result * 2 - expected, expected);
+}
+
+TEST(LimbResources, PoolReusesBuffers) {
+    LimbPool pool;
+    ResourceScope scope(&pool);
+    BigInteger value("1");
+    for (int i = 0; i < 200; i++)
+        value *= BigInteger("18446744073709551617");
+    BigInteger copy(value, &pool);
+    ASSERT_EQ(copy, value);
+    ASSERT_EQ(copy % BigInteger("18446744073709551617"), BigInteger(0));
+}
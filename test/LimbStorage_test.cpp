@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "../src/LimbStorage.h"
+
+using namespace BigNum;
+
+TEST(LimbStorage, SmallValuesStayInline) {
+    LimbStorage storage;
+    ASSERT_TRUE(storage.isInline());
+    storage.push_back(1);
+    storage.push_back(2);
+    ASSERT_TRUE(storage.isInline());
+    ASSERT_EQ(storage.size(), 2u);
+    ASSERT_EQ(storage[1], 2u);
+
+    LimbStorage copy = storage;
+    ASSERT_TRUE(copy.isInline());
+    ASSERT_EQ(copy, storage);
+}
+
+TEST(LimbStorage, SpillsToHeap) {
+    LimbStorage storage;
+    for (uint64_t i = 0; i < 10; i++)
+        storage.push_back(i);
+    ASSERT_FALSE(storage.isInline());
+    ASSERT_EQ(storage.size(), 10u);
+    for (uint64_t i = 0; i < 10; i++)
+        ASSERT_EQ(storage[i], i);
+
+    auto *buffer = storage.data();
+    LimbStorage moved = std::move(storage);
+    ASSERT_EQ(moved.data(), buffer);
+    ASSERT_TRUE(storage.empty());
+    ASSERT_TRUE(storage.isInline());
+
+    moved.resize(3);
+    moved.resize(5);
+    ASSERT_EQ(moved[4], 0u);
+    ASSERT_EQ(moved.data(), buffer);
+}
+
+TEST(LimbStorage, BorrowedCopiesOnWrite) {
+    const uint64_t source[4] = {1, 2, 3, 4};
+    LimbStorage view = LimbStorage::borrow(source, 4);
+    ASSERT_TRUE(view.isBorrowed());
+    ASSERT_EQ(static_cast<const LimbStorage &>(view).data(), source);
+
+    LimbStorage copy = view;
+    ASSERT_FALSE(copy.isBorrowed());
+    ASSERT_EQ(copy, view);
+
+    LimbStorage moved = std::move(view);
+    ASSERT_TRUE(moved.isBorrowed());
+    moved[0] = 10;
+    ASSERT_FALSE(moved.isBorrowed());
+    ASSERT_EQ(moved[0], 10u);
+    ASSERT_EQ(moved[3], 4u);
+    ASSERT_EQ(source[0], 1u);
+
+    LimbStorage small = LimbStorage::borrow(source, 2);
+    small.push_back(5);
+    ASSERT_EQ(small.size(), 3u);
+    ASSERT_EQ(small[2], 5u);
+    ASSERT_EQ(source[2], 3u);
+}
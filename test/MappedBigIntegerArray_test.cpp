@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "../src/MappedBigIntegerArray.h"
+
+using namespace BigNum;
+
+namespace {
+    std::string temporaryPath(const char *name) {
+        return ::testing::TempDir() + name;
+    }
+}
+
+TEST(MappedBigIntegerArray, ViewsUsableInArithmetic) {
+    BigInteger large = (BigInteger(1) << 500) - 3;
+    std::vector<BigInteger> values = {BigInteger(0), BigInteger(-7), large, -large * large, BigInteger(1) << 64};
+    std::string path = temporaryPath("bignum_mapped_array");
+    MappedBigIntegerArray::write(path, values);
+
+    MappedBigIntegerArray array(path);
+    ASSERT_EQ(array.size(), values.size());
+    for (size_t i = 0; i < values.size(); i++)
+        ASSERT_EQ(array[i], values[i]);
+    ASSERT_THROW(array.at(values.size()), std::out_of_range);
+
+    ASSERT_EQ(array[2] * array[2] + array[3], BigInteger(0));
+    ASSERT_EQ(array[3] / array[2], -large);
+    BigInteger view = array[3];
+    view += 1;
+    ASSERT_EQ(view, -large * large + 1);
+    ASSERT_EQ(array[3], -large * large);
+
+    MappedBigIntegerArray moved = std::move(array);
+    ASSERT_EQ(moved[4], values[4]);
+    std::remove(path.c_str());
+}
+
+TEST(MappedBigIntegerArray, RejectsMalformedFiles) {
+    ASSERT_THROW(MappedBigIntegerArray(temporaryPath("bignum_missing_array")), std::system_error);
+
+    std::string path = temporaryPath("bignum_malformed_array");
+    MappedBigIntegerArray::write(path, {BigInteger(5), BigInteger(6)});
+    {
+        // make the last element claim two limbs
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(7 * 8);
+        file.put(4);
+    }
+    ASSERT_THROW(MappedBigIntegerArray array(path), std::runtime_error);
+
+    std::ofstream(path, std::ios::binary) << "not an array at all!!!!!";
+    ASSERT_THROW(MappedBigIntegerArray array(path), std::runtime_error);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "../src/kernels.h"
+
+using namespace BigNum::kernels;
+
+namespace {
+    // random limbs biased towards 0 and all ones so that long carry runs get exercised
+    std::vector<limb_t> randomLimbs(std::mt19937_64 &gen, size_t n) {
+        std::vector<limb_t> res(n);
+        for (auto &limb : res) {
+            switch (gen() % 4) {
+                case 0:
+                    limb = 0;
+                    break;
+                case 1:
+                    limb = ~limb_t(0);
+                    break;
+                default:
+                    limb = gen();
+            }
+        }
+        return res;
+    }
+}
+
+TEST(Kernels, SetsAgreeWithPortable) {
+    std::mt19937_64 gen(42);
+    for (const KernelSet *set : supportedKernels()) {
+        for (size_t n = 0; n < 70; n++) {
+            for (int round = 0; round < 20; round++) {
+                auto a = randomLimbs(gen, n), b = randomLimbs(gen, n), r = randomLimbs(gen, n);
+                limb_t word = round % 3 ? gen() : ~limb_t(0);
+                std::vector<limb_t> expected(n), actual(n);
+
+                limb_t carry = PORTABLE_KERNELS.addN(expected.data(), a.data(), b.data(), n);
+                ASSERT_EQ(set->addN(actual.data(), a.data(), b.data(), n), carry) << set->name;
+                ASSERT_EQ(actual, expected) << set->name;
+
+                carry = PORTABLE_KERNELS.subN(expected.data(), a.data(), b.data(), n);
+                ASSERT_EQ(set->subN(actual.data(), a.data(), b.data(), n), carry) << set->name;
+                ASSERT_EQ(actual, expected) << set->name;
+
+                carry = PORTABLE_KERNELS.mul1(expected.data(), a.data(), n, word);
+                ASSERT_EQ(set->mul1(actual.data(), a.data(), n, word), carry) << set->name;
+                ASSERT_EQ(actual, expected) << set->name;
+
+                expected = actual = r;
+                carry = PORTABLE_KERNELS.addMul1(expected.data(), a.data(), n, word);
+                ASSERT_EQ(set->addMul1(actual.data(), a.data(), n, word), carry) << set->name;
+                ASSERT_EQ(actual, expected) << set->name;
+
+                ASSERT_EQ(set->popcount(a.data(), n), PORTABLE_KERNELS.popcount(a.data(), n)) << set->name;
+            }
+        }
+    }
+}
+
+TEST(Kernels, InPlace) {
+    std::mt19937_64 gen(7);
+    for (const KernelSet *set : supportedKernels()) {
+        auto a = randomLimbs(gen, 37), b = randomLimbs(gen, 37);
+        auto expected = a, actual = a;
+        PORTABLE_KERNELS.addN(expected.data(), expected.data(), b.data(), 37);
+        set->addN(actual.data(), actual.data(), b.data(), 37);
+        ASSERT_EQ(actual, expected) << set->name;
+        PORTABLE_KERNELS.subN(expected.data(), expected.data(), b.data(), 37);
+        set->subN(actual.data(), actual.data(), b.data(), 37);
+        ASSERT_EQ(actual, a) << set->name;
+        PORTABLE_KERNELS.mul1(expected.data(), expected.data(), 37, 12345);
+        set->mul1(actual.data(), actual.data(), 37, 12345);
+        ASSERT_EQ(actual, expected) << set->name;
+    }
+}
+
+TEST(Kernels, DivideByLimb) {
+    std::mt19937_64 gen(11);
+    for (size_t n = 0; n < 40; n++) {
+        for (int round = 0; round < 20; round++) {
+            auto a = randomLimbs(gen, n);
+            limb_t d = gen() >> (gen() % 64);
+            if (round % 5 == 0)
+                d = limb_t(1) << (gen() % 64);
+            d = d ? d : 1;
+
+            std::vector<limb_t> expected(n);
+            limb_t rem = 0;
+            for (size_t i = n; i-- > 0;) {
+                dlimb_t cur = ((dlimb_t) rem << LIMB_BITS) | a[i];
+                expected[i] = (limb_t) (cur / d);
+                rem = (limb_t) (cur % d);
+            }
+            ASSERT_EQ(mod1(a.data(), n, d), rem);
+            ASSERT_EQ(divRem1(a.data(), a.data(), n, d), rem);
+            ASSERT_EQ(a, expected);
+        }
+    }
+}